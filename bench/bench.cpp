@@ -0,0 +1,1178 @@
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <deque>
+#include <vector>
+#include <random>
+#include <iterator>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "lst.hpp"
+#include "cqueue.hpp"
+#include "shared_list.hpp"
+#include "lru.hpp"
+
+/*
+Benchmarks of the list against std::list, std::deque and
+std::vector. Usage: lst_bench [max_size] (1e6 by default);
+sizes go from 1e3 up to *max_size* by powers of ten. Results
+are printed to stdout as JSON: one record per benchmark,
+container and size, with the time per operation in ns.
+
+Operations that are O(n) for a container (middle insertion
+into a vector, taking an element of std::list by its number)
+are made fewer times, see slow_ops ()
+
+The concurrent queue benchmarks (mpsc_queue, spsc_queue) run
+once, after all the sizes: *n* is the number of producer threads
+there, and cqueue_t is compared with a list_t behind a mutex.
+They double as a stress test of cqueue_t: the consumer checks that
+every producer's elements come out in the order they were pushed,
+and the queue is verified after the producers are joined. A failure
+is reported to stderr, and lst_bench exits with 1.
+So do the shared list benchmarks (shared_take): *n* is the number
+of reader threads taking elements by their numbers while one writer
+inserts and deletes nodes in the middle; shlist_t is compared with
+a list_t behind a std::shared_mutex.
+
+The LRU cache benchmarks (lru) run for every size, *n* being the
+cache's capacity: lookups of skewed random keys out of 2 * *n*,
+a miss inserts the key. lru_t is compared with a list_t and
+a std::list (each with a std::unordered_map beside it)
+
+The reload benchmarks (reload, flat layout only) get a list of
+*n* elements ready for use: reopening a file-backed list with
+list_open () against building it anew by list_insert_back ().
+The time is given per element.
+
+The snapshot benchmarks (save, load) stream a list of *n*
+consecutive numbers to and from a memory buffer with list_save ()
+and list_load (), plain and packed, and have their rate in GB/s
+as well; copying a std::vector with memcpy () is the baseline.
+
+The huge pages benchmarks (traverse, "shuffled") walk a list whose
+nodes are linked in random order (sorted by random values with
+list_sort_by ()), with the default allocator and LIST_HUGE_PAGES
+*/
+
+static const ssize_t DEFAULT_MAX_SIZE = 1000000;
+static const ssize_t MIN_SIZE = 1000;
+static const ssize_t MID_OPS = 1000;
+static const ssize_t TAKE_OPS = 1000000;
+static const ssize_t SLOW_BUDGET = 100000000;       // Element moves / visits allowed for O(n) operations
+static const ssize_t QUEUE_CAP = 1024;
+static const ssize_t QUEUE_ITEMS = 1000000;
+static const ssize_t MAX_PRODUCERS = 8;
+static const ssize_t SHARED_SIZE = 100000;
+static const ssize_t RELOADS = 10;
+#if !defined (LIST_SEGMENTED_STORAGE) && !defined (LIST_SOA_STORAGE)
+static const char *RELOAD_FILE = "lst_bench.map";
+#endif
+
+static bool first_record = true;
+static bool check_failed = false;
+static volatile long long sink = 0;
+
+static double now_ns ();
+static ssize_t slow_ops (ssize_t n);
+static void report (const char *bench, const char *container, ssize_t n, ssize_t ops, double ns);
+static void report_rate (const char *bench, const char *container, ssize_t n, double ns);
+static void list_build (list_t *lst, ssize_t n, bool scrambled);
+static void bench_huge (ssize_t n);
+static void bench_growth (ssize_t n);
+static void bench_list (ssize_t n);
+static void bench_queue (ssize_t producers, CQ_MODE mode);
+static void bench_locked_list (ssize_t producers, const char *bench);
+static void bench_shared (ssize_t readers);
+static void bench_rw_locked (ssize_t readers);
+static void bench_lru (ssize_t n);
+static elem_t lru_key (std::mt19937_64 &rng, ssize_t n);
+static void bench_reload (ssize_t n);
+static void bench_snapshot (ssize_t n);
+static bool snap_write (const void *buf, size_t len, void *ctx);
+static bool snap_read (void *buf, size_t len, void *ctx);
+
+template <typename C>
+static void bench_std (const char *name, ssize_t n);
+
+int main (int argc, char **argv) {
+
+    ssize_t max_size = (argc > 1) ? atoll (argv [1]) : DEFAULT_MAX_SIZE;
+
+#if defined (LIST_SEGMENTED_STORAGE) && defined (LIST_SOA_STORAGE)
+    const char *layout = "segmented_soa";
+#elif defined (LIST_SEGMENTED_STORAGE)
+    const char *layout = "segmented";
+#elif defined (LIST_SOA_STORAGE)
+    const char *layout = "soa";
+#else
+    const char *layout = "flat";
+#endif
+
+#ifdef LIST_COMPACT_IDX
+    int idx_bits = 32;
+#else
+    int idx_bits = 64;
+#endif
+
+    printf ("{\n  \"layout\": \"%s\",\n  \"idx_bits\": %d,\n  \"results\": [", layout, idx_bits);
+
+    for (ssize_t n = MIN_SIZE; n <= max_size; n *= 10) {
+
+        bench_list (n);
+        bench_std<std::list<elem_t>> ("std::list", n);
+        bench_std<std::deque<elem_t>> ("std::deque", n);
+        bench_std<std::vector<elem_t>> ("std::vector", n);
+        bench_lru (n);
+        bench_reload (n);
+        bench_snapshot (n);
+        bench_huge (n);
+        bench_growth (n);
+    }
+
+    bench_queue (1, CQ_SPSC);
+    bench_locked_list (1, "spsc_queue");
+
+    ssize_t max_producers = (ssize_t) std::thread::hardware_concurrency () - 1;
+    max_producers = (max_producers > MAX_PRODUCERS) ? MAX_PRODUCERS : (max_producers < 2) ? 2 : max_producers;     // At least 2: the stress test needs concurrent pushes
+
+    for (ssize_t producers = 1; producers <= max_producers; producers *= 2) {
+
+        bench_queue (producers, CQ_MPSC);
+        bench_locked_list (producers, "mpsc_queue");
+    }
+
+    for (ssize_t readers = 1; readers <= max_producers; readers *= 2) {
+
+        bench_shared (readers);
+        bench_rw_locked (readers);
+    }
+
+    printf ("\n  ]\n}\n");
+
+    return check_failed ? 1 : 0;
+}
+
+static double now_ns () {
+
+    return (double) std::chrono::duration_cast<std::chrono::nanoseconds> (
+                    std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+static ssize_t slow_ops (ssize_t n) {
+
+    ssize_t ops = SLOW_BUDGET / n;
+
+    if (ops > MID_OPS) {
+
+        ops = MID_OPS;
+    }
+
+    return (ops > 0) ? ops : 1;
+}
+
+static void report (const char *bench, const char *container, ssize_t n, ssize_t ops, double ns) {
+
+    printf ("%s\n    {\"bench\": \"%s\", \"container\": \"%s\", \"n\": %lld, \"ops\": %lld, \"ns_per_op\": %.3f}",
+            first_record ? "" : ",", bench, container, (long long) n, (long long) ops, ns / ops);
+
+    first_record = false;
+}
+
+/*
+For streaming benchmarks: *ops* is the number of elements,
+and the rate is given in GB of elements per second
+*/
+
+static void report_rate (const char *bench, const char *container, ssize_t n, double ns) {
+
+    printf ("%s\n    {\"bench\": \"%s\", \"container\": \"%s\", \"n\": %lld, \"ops\": %lld, \"ns_per_op\": %.3f, \"gb_per_s\": %.3f}",
+            first_record ? "" : ",", bench, container, (long long) n, (long long) n, ns / n,
+            (double) n * sizeof (elem_t) / ns);
+
+    first_record = false;
+}
+
+/*
+Builds a list of *n* elements. A scrambled list is built by
+inserting to the front and to the back in turns, so logical
+numbers and positions don't match and the quick mode is off
+*/
+
+static void list_build (list_t *lst, ssize_t n, bool scrambled) {
+
+    list_ctor (lst);
+    list_verify_level (lst, VER_OFF);
+    list_reserve (lst, n + MID_OPS);               // Room for the middle insertions, so that they don't grow the list
+
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        if (scrambled && i % 2) {
+
+            list_insert_front (lst, (elem_t) i);
+
+        } else {
+
+            list_insert_back (lst, (elem_t) i);
+        }
+    }
+}
+
+static void bench_list (ssize_t n) {
+
+    std::mt19937_64 rng (n);
+    list_t lst = {};
+    double start = 0;
+
+    /* Insertion to the back: with growth, reserved in advance and unchecked */
+
+    list_ctor (&lst);
+    list_verify_level (&lst, VER_OFF);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_insert_back (&lst, (elem_t) i);
+    }
+    report ("push_back", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    list_ctor (&lst);
+    list_verify_level (&lst, VER_OFF);
+    list_reserve (&lst, n);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_insert_back (&lst, (elem_t) i);
+    }
+    report ("push_back_reserved", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    list_ctor (&lst);
+    list_verify_level (&lst, VER_OFF);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_insert_back_unchecked (&lst, (elem_t) i);
+    }
+    report ("push_back_unchecked", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Bulk loading: appending a span and building from an array */
+
+    std::vector<elem_t> vals (n);
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        vals [i] = (elem_t) i;
+    }
+
+    list_ctor (&lst);
+    list_verify_level (&lst, VER_OFF);
+    start = now_ns ();
+    list_insert_span_after (&lst, vals.data (), n, list_tail (&lst));
+    report ("push_back_span", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    start = now_ns ();
+    list_ctor_from (&lst, vals.data (), n);
+    report ("build_from_array", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Insertion to the front */
+
+    list_ctor (&lst);
+    list_verify_level (&lst, VER_OFF);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_insert_front (&lst, (elem_t) i);
+    }
+    report ("push_front", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Insertion and deletion in the middle */
+
+    ssize_t ops = (n < MID_OPS) ? n : MID_OPS;
+
+    list_build (&lst, n, false);
+    ssize_t pos = list_take (&lst, n / 2);
+    start = now_ns ();
+    for (ssize_t i = 0; i < ops; ++ i) {
+
+        list_insert_after (&lst, (elem_t) i, pos);
+    }
+    report ("insert_middle", "list_t", n, ops, now_ns () - start);
+
+    pos = list_take (&lst, n / 2);
+    start = now_ns ();
+    for (ssize_t i = 0; i < ops; ++ i) {
+
+        ssize_t next = node_next (&lst, pos);
+        list_delete (&lst, pos);
+        pos = next;
+    }
+    report ("delete_middle", "list_t", n, ops, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Deletion of the head and of the tail */
+
+    list_build (&lst, n, false);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_delete_back (&lst);
+    }
+    report ("pop_back", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    list_build (&lst, n, false);
+    start = now_ns ();
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_delete_front (&lst);
+    }
+    report ("pop_front", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Taking nodes by their logical numbers and traversal: quick mode */
+
+    list_build (&lst, n, false);
+    start = now_ns ();
+    for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+        sink += list_take (&lst, (ssize_t) (rng () % n) + 1);
+    }
+    report ("take", "list_t (quick mode)", n, TAKE_OPS, now_ns () - start);
+
+    long long sum = 0;
+    start = now_ns ();
+    for (ssize_t idx = list_head (&lst); idx != FICT; idx = list_next (&lst, idx)) {
+
+        sum += list_elem (&lst, idx);
+    }
+    report ("traverse", "list_t (quick mode)", n, n, now_ns () - start);
+    sink += sum;
+
+    /* Finding a node by value: scanning and the value index */
+
+    ops = slow_ops (n);
+    start = now_ns ();
+    for (ssize_t i = 0; i < ops; ++ i) {
+
+        sink += list_find (&lst, (elem_t) (rng () % n));
+    }
+    report ("find", "list_t (scan)", n, ops, now_ns () - start);
+
+    if (list_hash_on (&lst) == HASH_ON) {
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            sink += list_find (&lst, (elem_t) (rng () % n));
+        }
+        report ("find", "list_t (value index)", n, TAKE_OPS, now_ns () - start);
+    }
+    list_dtor (&lst);
+
+    /* Queue: popping the head and pushing to the tail, then taking a node (ring mode) */
+
+    list_build (&lst, n, false);
+    start = now_ns ();
+    for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+        list_delete_front (&lst);
+        list_insert_back (&lst, (elem_t) i);
+        sink += list_take (&lst, (ssize_t) (rng () % n) + 1);
+    }
+    report ("queue_cycle", "list_t", n, TAKE_OPS, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Same out of the quick mode: walking, with the order index, and sorting */
+
+    list_build (&lst, n, true);
+
+    ops = slow_ops (n);
+    start = now_ns ();
+    for (ssize_t i = 0; i < ops; ++ i) {
+
+        sink += list_take (&lst, (ssize_t) (rng () % n) + 1);
+    }
+    report ("take", "list_t (walk)", n, ops, now_ns () - start);
+
+    sum = 0;
+    start = now_ns ();
+    for (ssize_t idx = list_head (&lst); idx != FICT; idx = list_next (&lst, idx)) {
+
+        sum += list_elem (&lst, idx);
+    }
+    report ("traverse", "list_t (scrambled)", n, n, now_ns () - start);
+    sink += sum;
+
+    if (list_ord_on (&lst) == ORD_ON) {
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            sink += list_take (&lst, (ssize_t) (rng () % n) + 1);
+        }
+        report ("take", "list_t (order index)", n, TAKE_OPS, now_ns () - start);
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            list_rotate (&lst, (ssize_t) (rng () % n));
+        }
+        report ("rotate", "list_t (order index)", n, TAKE_OPS, now_ns () - start);
+        list_ord_off (&lst);
+    }
+
+    start = now_ns ();
+    list_verify (&lst);
+    report ("verify", "list_t", n, n, now_ns () - start);
+
+    start = now_ns ();
+    list_verify_parallel (&lst);
+    report ("verify", "list_t (parallel)", n, n, now_ns () - start);
+
+    start = now_ns ();
+    list_sort (&lst);
+    report ("sort", "list_t", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    list_build (&lst, n, true);
+    start = now_ns ();
+    list_sort_parallel (&lst);
+    report ("sort", "list_t (parallel)", n, n, now_ns () - start);
+    list_dtor (&lst);
+
+    /* Sorting by value (random elements, scrambled nodes) */
+
+    const char *value_sorts [2] = {"list_t (merge)", "list_t (radix)"};
+    for (int i = 0; i < 2; ++ i) {
+
+        std::mt19937_64 vals (n);
+        list_build (&lst, n, true);
+        for (ssize_t idx = list_head (&lst); idx != FICT; idx = list_next (&lst, idx)) {
+
+            list_elem (&lst, idx) = (elem_t) vals ();
+        }
+
+        start = now_ns ();
+        if (i == 0) {
+
+            list_sort_by (&lst);
+
+        } else {
+
+            list_sort_radix (&lst);
+        }
+        report ("value_sort", value_sorts [i], n, n, now_ns () - start);
+        list_dtor (&lst);
+    }
+}
+
+template <typename C>
+static void bench_std (const char *name, ssize_t n) {
+
+    std::mt19937_64 rng (n);
+    double start = 0;
+
+    /* Insertion to the back and to the front */
+
+    {
+        C cont;
+        start = now_ns ();
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            cont.push_back ((elem_t) i);
+        }
+        report ("push_back", name, n, n, now_ns () - start);
+    }
+
+    {
+        C cont;
+        ssize_t ops = std::is_same<C, std::vector<elem_t>>::value ? slow_ops (n) : n;
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            cont.insert (cont.begin (), (elem_t) i);
+        }
+        report ("push_front", name, n, ops, now_ns () - start);
+    }
+
+    /* Insertion and deletion in the middle */
+
+    {
+        C cont;
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            cont.push_back ((elem_t) i);
+        }
+
+        bool linked = std::is_same<C, std::list<elem_t>>::value;
+        ssize_t ops = linked ? ((n < MID_OPS) ? n : MID_OPS) : slow_ops (n);
+
+        auto pos = std::next (cont.begin (), n / 2);
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            pos = cont.insert (linked ? pos : std::next (cont.begin (), n / 2), (elem_t) i);
+        }
+        report ("insert_middle", name, n, ops, now_ns () - start);
+
+        pos = std::next (cont.begin (), n / 2);
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            pos = cont.erase (linked ? pos : std::next (cont.begin (), n / 2));
+        }
+        report ("delete_middle", name, n, ops, now_ns () - start);
+    }
+
+    /* Deletion of the head and of the tail */
+
+    {
+        C cont (n);
+        start = now_ns ();
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            cont.pop_back ();
+        }
+        report ("pop_back", name, n, n, now_ns () - start);
+    }
+
+    {
+        C cont (n);
+        ssize_t ops = std::is_same<C, std::vector<elem_t>>::value ? slow_ops (n) : n;
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            cont.erase (cont.begin ());
+        }
+        report ("pop_front", name, n, ops, now_ns () - start);
+    }
+
+    /* Taking an element by its number and traversal */
+
+    {
+        C cont;
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            cont.push_back ((elem_t) i);
+        }
+
+        ssize_t ops = std::is_same<C, std::list<elem_t>>::value ? slow_ops (n) : TAKE_OPS;
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            sink += *std::next (cont.begin (), (ssize_t) (rng () % n));
+        }
+        report ("take", name, n, ops, now_ns () - start);
+
+        long long sum = 0;
+        start = now_ns ();
+        for (elem_t elem : cont) {
+
+            sum += elem;
+        }
+        report ("traverse", name, n, n, now_ns () - start);
+        sink += sum;
+
+        ops = slow_ops (n);
+        start = now_ns ();
+        for (ssize_t i = 0; i < ops; ++ i) {
+
+            sink += *std::find (cont.begin (), cont.end (), (elem_t) (rng () % n));
+        }
+        report ("find", name, n, ops, now_ns () - start);
+    }
+
+    if (std::is_same<C, std::deque<elem_t>>::value) {
+
+        C cont (n);
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            cont.erase (cont.begin ());
+            cont.push_back ((elem_t) i);
+            sink += *std::next (cont.begin (), (ssize_t) (rng () % n));
+        }
+        report ("queue_cycle", name, n, TAKE_OPS, now_ns () - start);
+    }
+
+    /* Sorting by value (the same elements as the list gets) */
+
+    {
+        std::mt19937_64 vals (n);
+        C cont;
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            cont.push_back ((elem_t) vals ());
+        }
+
+        start = now_ns ();
+        if constexpr (std::is_same<C, std::list<elem_t>>::value) {
+
+            cont.sort ();
+
+        } else {
+
+            std::sort (cont.begin (), cont.end ());
+        }
+        report ("value_sort", name, n, n, now_ns () - start);
+        sink += *cont.begin ();
+    }
+}
+
+/*
+Producers push QUEUE_ITEMS elements in total (retrying while the
+queue is full), the main thread pops them all. Element i of
+producer p is p * (QUEUE_ITEMS / producers) + i, so the consumer
+can check the order of each producer's elements
+*/
+
+static void bench_queue (ssize_t producers, CQ_MODE mode) {
+
+    cqueue_t que;
+    if (cqueue_ctor (&que, QUEUE_CAP, mode) != CONSTRUCTED) {
+
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    double start = now_ns ();
+
+    for (ssize_t p = 0; p < producers; ++ p) {
+
+        threads.emplace_back ([&que, producers, p] () {
+
+            ssize_t per = QUEUE_ITEMS / producers;
+            for (ssize_t i = 0; i < per; ++ i) {
+
+                while (cqueue_push (&que, (elem_t) (p * per + i)) == CQ_FULL) {
+
+                    std::this_thread::yield ();
+                }
+            }
+        });
+    }
+
+    long long sum = 0;
+    elem_t val = 0;
+    ssize_t per = QUEUE_ITEMS / producers, out_of_order = 0;
+    std::vector<ssize_t> next_seq (producers, 0);
+
+    for (ssize_t popped = 0; popped < per * producers; ) {
+
+        if (cqueue_pop (&que, &val) == CQ_DONE) {
+
+            ssize_t p = val / per;
+            if (p < 0 || p >= producers || val % per != next_seq [p]) {
+
+                out_of_order += 1;
+
+            } else {
+
+                next_seq [p] += 1;
+            }
+
+            sum += val;
+            popped += 1;
+
+        } else {
+
+            std::this_thread::yield ();
+        }
+    }
+
+    for (std::thread &thread : threads) {
+
+        thread.join ();
+    }
+
+    VERIFICATION_CODE code = cqueue_verify (&que);
+    if (out_of_order != 0 || code != NO_FLAWS || cqueue_pop (&que, &val) != CQ_EMPTY) {
+
+        fprintf (stderr, "%s with %lld producers: %lld elements out of order, verification code %d\n",
+                 (mode == CQ_SPSC) ? "spsc_queue" : "mpsc_queue", (long long) producers, (long long) out_of_order, (int) code);
+        check_failed = true;
+    }
+
+    report ((mode == CQ_SPSC) ? "spsc_queue" : "mpsc_queue", "cqueue_t", producers, QUEUE_ITEMS / producers * producers, now_ns () - start);
+    sink += sum;
+
+    cqueue_dtor (&que);
+}
+
+static void bench_locked_list (ssize_t producers, const char *bench) {
+
+    list_t lst;
+    list_ctor (&lst, QUEUE_CAP);
+    list_verify_level (&lst, VER_OFF);
+
+    std::mutex lock;
+    std::vector<std::thread> threads;
+    double start = now_ns ();
+
+    for (ssize_t p = 0; p < producers; ++ p) {
+
+        threads.emplace_back ([&lst, &lock, producers] () {
+
+            for (ssize_t i = 0; i < QUEUE_ITEMS / producers; ) {
+
+                {
+                    std::lock_guard<std::mutex> guard (lock);
+                    if (lst.size < QUEUE_CAP) {
+
+                        list_insert_back (&lst, (elem_t) i);
+                        i += 1;
+                        continue;
+                    }
+                }
+
+                std::this_thread::yield ();
+            }
+        });
+    }
+
+    long long sum = 0;
+    for (ssize_t popped = 0; popped < QUEUE_ITEMS / producers * producers; ) {
+
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            if (lst.size != 0) {
+
+                sum += list_elem (&lst, list_head (&lst));
+                list_delete_front (&lst);
+                popped += 1;
+                continue;
+            }
+        }
+
+        std::this_thread::yield ();
+    }
+
+    for (std::thread &thread : threads) {
+
+        thread.join ();
+    }
+
+    report (bench, "list_t + std::mutex", producers, QUEUE_ITEMS / producers * producers, now_ns () - start);
+    sink += sum;
+
+    list_dtor (&lst);
+}
+
+/*
+Readers make TAKE_OPS takes in total; the writer keeps inserting
+and deleting a node in the middle until they are done. The order
+index is on, so that the takes stay O(log n) out of the quick mode
+*/
+
+static void bench_shared (ssize_t readers) {
+
+    shlist_t sh;
+    if (shlist_ctor (&sh, SHARED_SIZE + 1) != CONSTRUCTED) {
+
+        return;
+    }
+
+    list_t *lst = shlist_write_begin (&sh);
+    list_verify_level (lst, VER_OFF);
+    for (ssize_t i = 0; i < SHARED_SIZE; ++ i) {
+
+        list_insert_back (lst, (elem_t) i);
+    }
+    list_ord_on (lst);
+    shlist_write_end (&sh);
+
+    std::atomic<bool> done (false);
+    std::thread writer ([&sh, &done] () {
+
+        while (!done.load (std::memory_order_relaxed)) {
+
+            shlist_seq_insert_after (&sh, 0, SHARED_SIZE / 2);
+            shlist_seq_delete (&sh, SHARED_SIZE / 2 + 1);
+            std::this_thread::yield ();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    std::vector<long long> sums (readers, 0);           // Folded into *sink* after the join: readers don't share it
+    double start = now_ns ();
+
+    for (ssize_t r = 0; r < readers; ++ r) {
+
+        threads.emplace_back ([&sh, &sums, readers, r] () {
+
+            std::mt19937 rng ((unsigned) r);
+            long long sum = 0;
+            elem_t val = 0;
+
+            for (ssize_t i = 0; i < TAKE_OPS / readers; ++ i) {
+
+                shlist_take (&sh, (ssize_t) (rng () % SHARED_SIZE) + 1, &val);
+                sum += val;
+            }
+
+            sums [r] = sum;
+        });
+    }
+
+    for (std::thread &thread : threads) {
+
+        thread.join ();
+    }
+
+    for (long long sum : sums) {
+
+        sink += sum;
+    }
+
+    report ("shared_take", "shlist_t", readers, TAKE_OPS / readers * readers, now_ns () - start);
+
+    done.store (true);
+    writer.join ();
+    shlist_dtor (&sh);
+}
+
+static void bench_rw_locked (ssize_t readers) {
+
+    list_t lst;
+    list_build (&lst, SHARED_SIZE, false);
+    list_ord_on (&lst);
+
+    std::shared_mutex lock;
+    std::atomic<bool> done (false);
+    std::thread writer ([&lst, &lock, &done] () {
+
+        while (!done.load (std::memory_order_relaxed)) {
+
+            {
+                std::unique_lock<std::shared_mutex> guard (lock);
+                list_seq_insert_after (&lst, 0, SHARED_SIZE / 2);
+                list_seq_delete (&lst, SHARED_SIZE / 2 + 1);
+            }
+
+            std::this_thread::yield ();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    std::vector<long long> sums (readers, 0);
+    double start = now_ns ();
+
+    for (ssize_t r = 0; r < readers; ++ r) {
+
+        threads.emplace_back ([&lst, &lock, &sums, readers, r] () {
+
+            std::mt19937 rng ((unsigned) r);
+            long long sum = 0;
+
+            for (ssize_t i = 0; i < TAKE_OPS / readers; ++ i) {
+
+                std::shared_lock<std::shared_mutex> guard (lock);
+                sum += list_elem (&lst, list_take (&lst, (ssize_t) (rng () % SHARED_SIZE) + 1));
+            }
+
+            sums [r] = sum;
+        });
+    }
+
+    for (std::thread &thread : threads) {
+
+        thread.join ();
+    }
+
+    for (long long sum : sums) {
+
+        sink += sum;
+    }
+
+    report ("shared_take", "list_t + std::shared_mutex", readers, TAKE_OPS / readers * readers, now_ns () - start);
+
+    done.store (true);
+    writer.join ();
+    list_dtor (&lst);
+}
+
+/*
+Small keys are much more likely: a key is uniform
+below a bound that is uniform itself
+*/
+
+static elem_t lru_key (std::mt19937_64 &rng, ssize_t n) {
+
+    return (elem_t) (rng () % (rng () % (2 * n) + 1));
+}
+
+static void bench_lru (ssize_t n) {
+
+    double start = 0;
+    elem_t val = 0;
+
+    {
+        std::mt19937_64 rng (n);
+        lru_t cache = {};
+        lru_ctor (&cache, n);
+        list_verify_level (&cache.lst, VER_OFF);
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            elem_t key = lru_key (rng, n);
+            if (!lru_get (&cache, key, &val)) {
+
+                lru_put (&cache, key, (elem_t) i);
+            }
+            sink += val;
+        }
+        report ("lru", "lru_t", n, TAKE_OPS, now_ns () - start);
+        lru_dtor (&cache);
+    }
+
+    /* Move to the front as a deletion and an insertion */
+
+    {
+        std::mt19937_64 rng (n);
+        list_t lst = {};
+        list_ctor (&lst, n);
+        list_verify_level (&lst, VER_OFF);
+        std::unordered_map<elem_t, std::pair<ssize_t, elem_t>> map;
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            elem_t key = lru_key (rng, n);
+            auto found = map.find (key);
+
+            if (found != map.end ()) {
+
+                list_delete (&lst, found->second.first);
+                found->second.first = list_insert_front (&lst, key);
+                val = found->second.second;
+
+            } else {
+
+                if (lst.size == n) {
+
+                    map.erase (list_elem (&lst, list_tail (&lst)));
+                    list_delete_back (&lst);
+                }
+
+                map [key] = {list_insert_front (&lst, key), (elem_t) i};
+            }
+            sink += val;
+        }
+        report ("lru", "list_t + unordered_map", n, TAKE_OPS, now_ns () - start);
+        list_dtor (&lst);
+    }
+
+    {
+        std::mt19937_64 rng (n);
+        std::list<std::pair<elem_t, elem_t>> order;
+        std::unordered_map<elem_t, std::list<std::pair<elem_t, elem_t>>::iterator> map;
+
+        start = now_ns ();
+        for (ssize_t i = 0; i < TAKE_OPS; ++ i) {
+
+            elem_t key = lru_key (rng, n);
+            auto found = map.find (key);
+
+            if (found != map.end ()) {
+
+                order.splice (order.begin (), order, found->second);
+                val = found->second->second;
+
+            } else {
+
+                if ((ssize_t) order.size () == n) {
+
+                    map.erase (order.back ().first);
+                    order.pop_back ();
+                }
+
+                order.emplace_front (key, (elem_t) i);
+                map [key] = order.begin ();
+            }
+            sink += val;
+        }
+        report ("lru", "std::list + unordered_map", n, TAKE_OPS, now_ns () - start);
+    }
+}
+
+static void bench_reload (ssize_t n) {
+
+#if !defined (LIST_SEGMENTED_STORAGE) && !defined (LIST_SOA_STORAGE)
+    list_t lst = {};
+    double start = 0;
+
+    list_ctor_mapped (&lst, RELOAD_FILE, n);
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        list_insert_back (&lst, (elem_t) i);
+    }
+    list_dtor (&lst);
+
+    start = now_ns ();
+    for (ssize_t i = 0; i < RELOADS; ++ i) {
+
+        list_open (&lst, RELOAD_FILE);
+        sink += list_elem (&lst, list_tail (&lst));
+        list_dtor (&lst);
+    }
+    report ("reload", "list_t (list_open)", n, n * RELOADS, now_ns () - start);
+    remove (RELOAD_FILE);
+
+    start = now_ns ();
+    for (ssize_t i = 0; i < RELOADS; ++ i) {
+
+        list_ctor (&lst, n);
+        list_verify_level (&lst, VER_OFF);
+        for (ssize_t j = 0; j < n; ++ j) {
+
+            list_insert_back (&lst, (elem_t) j);
+        }
+        sink += list_elem (&lst, list_tail (&lst));
+        list_dtor (&lst);
+    }
+    report ("reload", "list_t (rebuild)", n, n * RELOADS, now_ns () - start);
+#else
+    (void) n;
+#endif
+}
+
+struct snap_buf_t {
+
+    std::vector<char> bytes;
+    size_t at;
+};
+
+static bool snap_write (const void *buf, size_t len, void *ctx) {
+
+    snap_buf_t *snap = (snap_buf_t *) ctx;
+    snap->bytes.insert (snap->bytes.end (), (const char *) buf, (const char *) buf + len);
+
+    return true;
+}
+
+static bool snap_read (void *buf, size_t len, void *ctx) {
+
+    snap_buf_t *snap = (snap_buf_t *) ctx;
+    if (snap->bytes.size () - snap->at < len) {
+
+        return false;
+    }
+
+    memcpy (buf, snap->bytes.data () + snap->at, len);
+    snap->at += len;
+
+    return true;
+}
+
+static void bench_snapshot (ssize_t n) {
+
+    list_t lst = {};
+    double start = 0;
+
+    list_build (&lst, n, true);
+    list_sort (&lst);
+
+    const char *names [2] = {"list_t", "list_t (packed)"};
+    for (int packed = 0; packed < 2; ++ packed) {
+
+        snap_buf_t snap = {};
+        snap.bytes.reserve (n * sizeof (elem_t) + 4096);
+
+        start = now_ns ();
+        list_save (&lst, snap_write, &snap, packed);
+        report_rate ("save", names [packed], n, now_ns () - start);
+
+        list_t copy = {};
+        start = now_ns ();
+        list_load (&copy, snap_read, &snap);
+        report_rate ("load", names [packed], n, now_ns () - start);
+
+        sink += list_elem (&copy, list_tail (&copy));
+        list_dtor (&copy);
+    }
+    list_dtor (&lst);
+
+    std::vector<elem_t> vec (n, 1);
+    std::vector<elem_t> dst (n, 0);
+
+    start = now_ns ();
+    memcpy (dst.data (), vec.data (), n * sizeof (elem_t));
+    report_rate ("save", "std::vector (memcpy)", n, now_ns () - start);
+    sink += dst [n - 1];
+}
+
+static void bench_huge (ssize_t n) {
+
+    const list_alloc_t libc_alloc = {};
+    const list_alloc_t *allocs [2] = {&libc_alloc, &LIST_HUGE_PAGES};
+    const char *names [2] = {"list_t (shuffled)", "list_t (shuffled, huge pages)"};
+
+    for (int i = 0; i < 2; ++ i) {
+
+        std::mt19937_64 rng (n);
+        list_t lst = {};
+
+        list_ctor_alloc (&lst, allocs [i], n);
+        list_verify_level (&lst, VER_OFF);
+        for (ssize_t j = 0; j < n; ++ j) {
+
+            list_insert_back (&lst, (elem_t) rng ());
+        }
+        list_sort_by (&lst);
+
+        long long sum = 0;
+        double start = now_ns ();
+        for (ssize_t idx = list_head (&lst); idx != FICT; idx = list_next (&lst, idx)) {
+
+            sum += list_elem (&lst, idx);
+        }
+        report ("traverse", names [i], n, n, now_ns () - start);
+        sink += sum;
+
+        list_dtor (&lst);
+    }
+}
+
+/*
+Construction doesn't write the nodes, so it shouldn't depend on
+the capacity; push_back with growth policies other than doubling
+*/
+
+static void bench_growth (ssize_t n) {
+
+    list_t lst = {};
+
+    double start = now_ns ();
+    list_ctor (&lst, n);
+    report ("construct", "list_t", n, 1, now_ns () - start);
+    list_dtor (&lst);
+
+    const double factors [2] = {1.5, 1};
+    const ssize_t steps [2] = {0, 4096};
+    const char *names [2] = {"list_t (growth x1.5)", "list_t (growth +4096)"};
+
+    for (int i = 0; i < 2; ++ i) {
+
+        list_ctor (&lst);
+        list_verify_level (&lst, VER_OFF);
+        list_growth (&lst, factors [i], steps [i], 0);
+
+        start = now_ns ();
+        for (ssize_t j = 0; j < n; ++ j) {
+
+            list_insert_back (&lst, (elem_t) j);
+        }
+        report ("push_back", names [i], n, n, now_ns () - start);
+
+        list_dtor (&lst);
+    }
+}
@@ -0,0 +1,212 @@
+#include <new>
+
+#include "cqueue.hpp"
+
+static ssize_t free_pop (cqueue_t *que);
+static void free_push (cqueue_t *que, ssize_t idx);
+
+constexpr uint64_t TAG_UNIT = (uint64_t) 1 << 32;
+constexpr uint64_t IDX_MASK = TAG_UNIT - 1;
+
+CTOR_OPER_CODE cqueue_ctor (cqueue_t *que, ssize_t cap, CQ_MODE mode /* = CQ_MPSC */) {
+
+    assert (que);
+
+    if (cap < 0 || cap > CQ_MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld is out of the range [0; %lld]\n", cap, CQ_MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
+
+    que->data = (cq_node_t *) calloc (cap + 2, sizeof (cq_node_t));
+    if (que->data == NULL) {
+
+        printf ("\nConstruction failed: memory error\n");
+        return CTOR_MEM_ERROR;
+    }
+
+    /*
+    Node 1 is the first dummy, the free stack goes from 2 to cap + 1
+    */
+
+    for (ssize_t idx = 0; idx <= cap + 1; ++ idx) {
+
+        new (&que->data [idx].next) std::atomic<uint32_t> ((idx >= 2 && idx <= cap) ? (uint32_t) (idx + 1) : (uint32_t) FICT);
+        que->data [idx].elem = (idx <= 1) ? FICT_NODE_ELEM : FREE_NODE_ELEM;
+    }
+
+    que->cap = cap;
+    que->mode = mode;
+
+    que->free.store ((cap != 0) ? 2 : FICT, std::memory_order_relaxed);
+    que->tail.store (1, std::memory_order_relaxed);
+    que->head = 1;
+
+    return CONSTRUCTED;
+}
+
+void cqueue_dtor (cqueue_t *que) {
+
+    assert (que);
+
+    free (que->data);
+    que->data = (cq_node_t *) OS_RESERVED_ADDR;
+
+    que->cap = -1;
+}
+
+CQ_OPER_CODE cqueue_push (cqueue_t *que, elem_t val) {
+
+    assert (que);
+
+    ssize_t idx = free_pop (que);
+    if (idx == FICT) {
+
+        return CQ_FULL;
+    }
+
+    que->data [idx].elem = val;
+    que->data [idx].next.store (FICT, std::memory_order_relaxed);
+
+    ssize_t prev = 0;
+    if (que->mode == CQ_MPSC) {
+
+        prev = que->tail.exchange ((uint32_t) idx, std::memory_order_acq_rel);
+
+    } else {
+
+        prev = que->tail.load (std::memory_order_relaxed);
+        que->tail.store ((uint32_t) idx, std::memory_order_relaxed);
+    }
+
+    que->data [prev].next.store ((uint32_t) idx, std::memory_order_release);
+
+    return CQ_DONE;
+}
+
+CQ_OPER_CODE cqueue_pop (cqueue_t *que, elem_t *val) {
+
+    assert (que);
+    assert (val);
+
+    ssize_t dummy = que->head;
+    ssize_t idx = que->data [dummy].next.load (std::memory_order_acquire);
+
+    if (idx == FICT) {
+
+        return CQ_EMPTY;
+    }
+
+    *val = que->data [idx].elem;
+    que->head = (uint32_t) idx;
+
+    que->data [dummy].elem = FREE_NODE_ELEM;
+    free_push (que, dummy);
+
+    return CQ_DONE;
+}
+
+/*
+*next* of a node read by a producer may be stale (the node
+may have been popped by another producer and be in the queue
+already), but then the tag of the top has changed as well
+and the exchange fails
+*/
+
+static ssize_t free_pop (cqueue_t *que) {
+
+    uint64_t top = que->free.load (std::memory_order_acquire);
+
+    while ((top & IDX_MASK) != FICT) {
+
+        uint64_t next = que->data [top & IDX_MASK].next.load (std::memory_order_relaxed);
+
+        if (que->free.compare_exchange_weak (top, ((top & ~IDX_MASK) + TAG_UNIT) | next,
+                                             std::memory_order_acquire, std::memory_order_acquire)) {
+
+            return (ssize_t) (top & IDX_MASK);
+        }
+    }
+
+    return FICT;
+}
+
+static void free_push (cqueue_t *que, ssize_t idx) {
+
+    uint64_t top = que->free.load (std::memory_order_relaxed);
+
+    do {
+
+        que->data [idx].next.store ((uint32_t) (top & IDX_MASK), std::memory_order_relaxed);
+
+    } while (!que->free.compare_exchange_weak (top, ((top & ~IDX_MASK) + TAG_UNIT) | (uint64_t) idx,
+                                               std::memory_order_release, std::memory_order_relaxed));
+}
+
+VERIFICATION_CODE cqueue_verify (cqueue_t *que) {
+
+    assert (que);
+
+    if (que->data == NULL) {
+
+        printf ("\nVerification failed: queue's *data* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+    if (que->cap < 0) {
+
+        printf ("\nVerification failed: queue's *capacity* parameter ran below zero (%lld)\n", que->cap);
+        return CAP_FLAW;
+    }
+
+    ssize_t last = que->cap + 1;
+
+    if (que->head == FICT || que->head > last) {
+
+        printf ("\nVerification failed: queue's dummy node has an impossible index: %lld\n", (ssize_t) que->head);
+        return FICT_FLAW;
+    }
+
+    ssize_t nodes_handled = 1, idx = que->head, tail = que->head;
+    for (idx = que->data [idx].next.load (); idx != FICT && nodes_handled <= last; ++ nodes_handled) {
+
+        if (idx > last) {
+
+            printf ("\nVerification failed: the queue contains an impossible index: %lld \
+                    (number %lld in the order of the queue)\n", idx, nodes_handled);
+            return LST_IDX_FLAW;
+        }
+
+        tail = idx;
+        idx = que->data [idx].next.load ();
+    }
+
+    if (tail != que->tail.load ()) {
+
+        printf ("\nVerification failed: the last node of the queue is on position %lld, \
+                but its *tail* is %lld\n", tail, (ssize_t) que->tail.load ());
+        return LST_SEQUENCE_FLAW;
+    }
+
+    idx = que->free.load () & IDX_MASK;
+    for ( ; idx != FICT && nodes_handled <= last; ++ nodes_handled) {
+
+        if (idx > last) {
+
+            printf ("\nVerification failed: the free stack contains an impossible index: %lld\n", idx);
+            return FREE_IDX_FLAW;
+        }
+
+        idx = que->data [idx].next.load ();
+    }
+
+    if (nodes_handled != last) {
+
+        printf ("\nVerification failed: number of nodes in the queue and the free \
+                stack doesn't match queue's capacity (%lld against %lld)\n",
+                nodes_handled - 1, que->cap);
+        return INCOMPLETENESS_FLAW;
+    }
+
+    return NO_FLAWS;
+}
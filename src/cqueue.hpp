@@ -0,0 +1,66 @@
+#ifndef CQUEUE_ACTIVE
+#define CQUEUE_ACTIVE
+
+#include <atomic>
+
+#include "lst.hpp"
+
+/*
+Concurrent queue over the same kind of index-linked node array:
+producer threads call cqueue_push (), one consumer thread calls
+cqueue_pop (). All the nodes are allocated by the constructor (the
+capacity is fixed), so neither of them ever allocates memory or takes
+a lock. Node 0 is never used (FICT terminates the chains, as in the
+list), one more node than *cap* is allocated for the queue's dummy.
+
+The queue is singly linked: the consumer holds the dummy node at
+*head*, the first element is in the node after it; popping an element
+makes its node the new dummy and returns the old dummy to the free
+stack. Pushing links a node after *tail*. With CQ_MPSC *tail* is
+swapped atomically, so any number of producers can push at once
+(a push is wait-free as soon as it has a node); with CQ_SPSC there
+must be only one producer, and *tail* is a plain store. A push
+that has swapped *tail* but hasn't linked its node yet hides the
+nodes after it from the consumer until it does: cqueue_pop ()
+reports CQ_EMPTY then, so it's worth retrying.
+
+The free nodes form a Treiber stack. Its top is a tagged index
+(the index in the low 32 bits, a counter of changes in the high ones),
+so a producer that was preempted in the middle of a pop can't swap in
+a stale *next* after the node it saw has been popped and pushed back
+(ABA). The producers and the consumer work on separate cache lines.
+
+There is no automatic verification: cqueue_verify () may only be
+called when no thread is using the queue
+*/
+
+enum CQ_MODE {CQ_SPSC = 0, CQ_MPSC = 1};
+enum CQ_OPER_CODE {CQ_DONE = 0, CQ_FULL = 1, CQ_EMPTY = 2};
+
+constexpr ssize_t CQ_MAX_CAP = INT32_MAX - 1;                  // Node indexes are 32-bit
+
+struct cq_node_t {
+
+    elem_t elem;
+    std::atomic<uint32_t> next;
+};
+
+struct cqueue_t {
+
+    cq_node_t *data;
+    ssize_t cap;
+    CQ_MODE mode;
+
+    alignas (CACHE_LINE) std::atomic<uint64_t> free;           // Tagged top of the free stack
+    alignas (CACHE_LINE) std::atomic<uint32_t> tail;           // Producers' end
+    alignas (CACHE_LINE) uint32_t head;                        // Consumer's end (the dummy node)
+};
+
+CTOR_OPER_CODE cqueue_ctor (cqueue_t *que, ssize_t cap, CQ_MODE mode = CQ_MPSC);
+void cqueue_dtor (cqueue_t *que);
+VERIFICATION_CODE cqueue_verify (cqueue_t *que);
+
+CQ_OPER_CODE cqueue_push (cqueue_t *que, elem_t val);
+CQ_OPER_CODE cqueue_pop (cqueue_t *que, elem_t *val);
+
+#endif
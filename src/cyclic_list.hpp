@@ -0,0 +1,692 @@
+#ifndef CYCLIC_LIST_ACTIVE
+#define CYCLIC_LIST_ACTIVE
+
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "lst.hpp"
+
+/*
+Generic version of the list: elements of any type T are stored
+inline in the nodes. A free node's element is never constructed
+(a node is free if and only if its *prev* is FREE_NODE_MARKER,
+and the fictional node has no element at all), so unlike list_t
+this list doesn't reserve any values of T as markers.
+
+Elements are move-constructed into the nodes on insertion, and
+moved along with the nodes on resize and sort. Trivially
+copyable types keep the realloc () fast path on resize.
+If constructing an element throws, the exception goes through
+and the list stays as it was: insertion takes the free node only
+after the element is constructed, and resize copies the elements
+whose move constructor may throw (std::move_if_noexcept ()),
+so the old nodes are untouched until the new ones are ready.
+Sorting moves the elements in place, so a throw from it only
+keeps the list valid: every element stays in it (in a partly
+sorted order, the one being moved possibly moved from), the
+free list is rebuilt and the quick mode is off.
+
+The functions have the same names, arguments and return codes
+as the list_t ones
+*/
+
+template <typename T>
+struct cyclic_node_t {
+
+    alignas (T) unsigned char elem [sizeof (T)];
+    idx_t next;
+    idx_t prev;
+};
+
+template <typename T>
+struct cyclic_list {
+
+    cyclic_node_t<T> *data;
+    ssize_t free;
+    ssize_t cap;
+    ssize_t size;
+    bool quick_mode;
+};
+
+template <typename T>
+inline T &node_elem (cyclic_list<T> *lst, ssize_t idx) {
+
+    return *std::launder (reinterpret_cast<T *> (lst->data [idx].elem));
+}
+
+template <typename T>
+inline idx_t &node_next (cyclic_list<T> *lst, ssize_t idx) {
+
+    return lst->data [idx].next;
+}
+
+template <typename T>
+inline idx_t &node_prev (cyclic_list<T> *lst, ssize_t idx) {
+
+    return lst->data [idx].prev;
+}
+
+template <typename T>
+VERIFICATION_CODE list_verify (cyclic_list<T> *lst);
+
+template <typename T>
+static bool cl_resize_up (cyclic_list<T> *lst) {
+
+    static_assert (alignof (T) <= alignof (max_align_t), "over-aligned element types are not supported");
+
+    ssize_t old_cap = lst->cap, new_cap = old_cap * 2 + 1;
+    if (new_cap > MAX_CAP) {
+
+        return false;
+    }
+
+    cyclic_node_t<T> *buffer = NULL;
+
+    if constexpr (std::is_trivially_copyable<T>::value) {
+
+        buffer = (cyclic_node_t<T> *) realloc (lst->data, (new_cap + 1) * sizeof (cyclic_node_t<T>));
+        if (buffer == NULL) {
+
+            return false;
+        }
+
+    } else {
+
+        buffer = (cyclic_node_t<T> *) malloc ((new_cap + 1) * sizeof (cyclic_node_t<T>));
+        if (buffer == NULL) {
+
+            return false;
+        }
+
+        ssize_t idx = 0;
+        try {
+
+            for ( ; idx <= old_cap; ++ idx) {
+
+                buffer [idx].next = lst->data [idx].next;
+                buffer [idx].prev = lst->data [idx].prev;
+
+                if (idx != FICT && lst->data [idx].prev != FREE_NODE_MARKER) {
+
+                    new (buffer [idx].elem) T (std::move_if_noexcept (node_elem (lst, idx)));
+                }
+            }
+
+        } catch (...) {
+
+            for (ssize_t done = 1; done < idx; ++ done) {
+
+                if (buffer [done].prev != FREE_NODE_MARKER) {
+
+                    std::launder (reinterpret_cast<T *> (buffer [done].elem))->~T ();
+                }
+            }
+
+            free (buffer);
+            throw;
+        }
+
+        for (idx = 1; idx <= old_cap; ++ idx) {
+
+            if (lst->data [idx].prev != FREE_NODE_MARKER) {
+
+                node_elem (lst, idx).~T ();
+            }
+        }
+
+        free (lst->data);
+    }
+
+    lst->data = buffer;
+    lst->cap = new_cap;
+
+    ssize_t idx = old_cap + 1;
+    for ( ; idx < new_cap; ++ idx) {
+
+        node_prev (lst, idx) = FREE_NODE_MARKER;
+        node_next (lst, idx) = idx + 1;
+    }
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = lst->free;
+
+    lst->free = old_cap + 1;
+
+    return true;
+}
+
+template <typename T>
+static ssize_t cl_ins_before (cyclic_list<T> *lst, ssize_t idx, T &&val) {
+
+    ssize_t new_idx = lst->free;
+
+    new (lst->data [new_idx].elem) T (std::move (val));         // May throw, so the node is taken off the free list after it
+    lst->free = node_next (lst, new_idx);
+
+    node_prev (lst, new_idx) = node_prev (lst, idx);
+    node_next (lst, new_idx) = idx;
+    node_next (lst, node_prev (lst, idx)) = new_idx;
+    node_prev (lst, idx) = new_idx;
+
+    lst->size += 1;
+    return new_idx;
+}
+
+template <typename T>
+static ssize_t cl_ins_after (cyclic_list<T> *lst, ssize_t idx, T &&val) {
+
+    return cl_ins_before (lst, node_next (lst, idx), std::move (val));
+}
+
+template <typename T>
+static void cl_del (cyclic_list<T> *lst, ssize_t idx) {
+
+    node_elem (lst, idx).~T ();
+
+    node_prev (lst, node_next (lst, idx)) = node_prev (lst, idx);
+    node_next (lst, node_prev (lst, idx)) = node_next (lst, idx);
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = lst->free;
+    lst->free = idx;
+
+    lst->size -= 1;
+}
+
+/*
+Moves live node *idx1* to position *idx2*; if there was
+a live node on *idx2*, it is moved to *idx1*. If *idx2* was
+free, *idx1* becomes free, and the caller has to rebuild
+the free list (which is what the sorting func does anyway)
+*/
+
+template <typename T>
+static void cl_node_swap (cyclic_list<T> *lst, ssize_t idx1, ssize_t idx2) {
+
+    if (idx1 == idx2) {
+
+        return;
+    }
+
+    if (node_prev (lst, idx2) == FREE_NODE_MARKER) {
+
+        new (lst->data [idx2].elem) T (std::move (node_elem (lst, idx1)));
+        node_elem (lst, idx1).~T ();
+
+        node_next (lst, idx2) = node_next (lst, idx1);
+        node_prev (lst, idx2) = node_prev (lst, idx1);
+        node_next (lst, node_prev (lst, idx2)) = idx2;
+        node_prev (lst, node_next (lst, idx2)) = idx2;
+
+        node_prev (lst, idx1) = FREE_NODE_MARKER;
+        return;
+    }
+
+    using std::swap;
+    swap (node_elem (lst, idx1), node_elem (lst, idx2));
+
+    idx_t links [2][2] = {{node_next (lst, idx1), node_prev (lst, idx1)},
+                          {node_next (lst, idx2), node_prev (lst, idx2)}};
+
+    ssize_t swapped [2] = {idx2, idx1};                 // The node that was on idx1 goes to idx2 and vice versa
+    for (int i = 0; i < 2; ++ i) {
+
+        for (int j = 0; j < 2; ++ j) {
+
+            if (links [i][j] == idx1 || links [i][j] == idx2) {
+
+                links [i][j] = idx1 + idx2 - links [i][j];
+            }
+        }
+
+        node_next (lst, swapped [i]) = links [i][0];
+        node_prev (lst, swapped [i]) = links [i][1];
+    }
+
+    for (int i = 0; i < 2; ++ i) {
+
+        node_next (lst, node_prev (lst, swapped [i])) = swapped [i];
+        node_prev (lst, node_next (lst, swapped [i])) = swapped [i];
+    }
+}
+
+/*
+Links all the free nodes into the free list in the order of
+positions (after an interrupted sort, see list_sort ())
+*/
+
+template <typename T>
+static void cl_free_rebuild (cyclic_list<T> *lst) {
+
+    lst->free = FICT;
+    for (ssize_t idx = lst->cap; idx > 0; -- idx) {
+
+        if (node_prev (lst, idx) == FREE_NODE_MARKER) {
+
+            node_next (lst, idx) = lst->free;
+            lst->free = idx;
+        }
+    }
+}
+
+template <typename T>
+CTOR_OPER_CODE list_ctor (cyclic_list<T> *lst, ssize_t cap = 8) {
+
+    assert (lst);
+
+    if (cap > MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld exceeds the maximum capacity %lld\n", cap, MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
+
+    lst->data = (cyclic_node_t<T> *) calloc (cap + 1, sizeof (cyclic_node_t<T>));
+    if (lst->data == NULL) {
+
+        printf ("\nConstruction failed: memory error\n");
+        return CTOR_MEM_ERROR;
+    }
+
+    node_prev (lst, FICT) = NO_TAIL;
+    node_next (lst, FICT) = NO_HEAD;
+
+    for (ssize_t idx = 1; idx <= cap; ++ idx) {
+
+        node_prev (lst, idx) = FREE_NODE_MARKER;
+        node_next (lst, idx) = (idx < cap) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+    }
+
+    lst->free = (cap != 0) ? (ssize_t) 1 : (ssize_t) FICT;
+    lst->cap = cap;
+    lst->size = 0;
+    lst->quick_mode = true;
+
+    return CONSTRUCTED;
+}
+
+template <typename T>
+void list_dtor (cyclic_list<T> *lst) {
+
+    assert (lst);
+
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+
+        for (ssize_t idx = node_next (lst, FICT); idx != FICT; idx = node_next (lst, idx)) {
+
+            node_elem (lst, idx).~T ();
+        }
+    }
+
+    free (lst->data);
+    lst->data = (cyclic_node_t<T> *) OS_RESERVED_ADDR;
+
+    lst->cap = -1;
+    lst->free = -1;
+    lst->size = -1;
+    lst->quick_mode = false;
+}
+
+template <typename T>
+ssize_t list_insert_front (cyclic_list<T> *lst, T val) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (lst->free == FICT && !cl_resize_up (lst)) {
+
+        printf ("\nResize failed: memory error while trying to resize up \
+                from capacity %lld, in function list_insert_front ()\n", lst->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    lst->quick_mode = false;
+    return cl_ins_after (lst, FICT, std::move (val));
+}
+
+template <typename T>
+ssize_t list_insert_back (cyclic_list<T> *lst, T val) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (lst->free == FICT && !cl_resize_up (lst)) {
+
+        printf ("\nResize failed: memory error while trying to resize up \
+                from capacity %lld, in function list_insert_back ()\n", lst->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    return cl_ins_before (lst, FICT, std::move (val));
+}
+
+template <typename T>
+ssize_t list_insert_before (cyclic_list<T> *lst, T val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (pos > lst->cap || pos < 0 || node_prev (lst, pos) == FREE_NODE_MARKER) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free or nonexistent node while trying to insert \
+                an element before one on position %lld, in function list_insert_before ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->free == FICT && !cl_resize_up (lst)) {
+
+        printf ("\nResize failed: memory error while trying to resize up \
+                from capacity %lld, in function list_insert_before ()\n", lst->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    lst->quick_mode = false;
+    return cl_ins_before (lst, pos, std::move (val));
+}
+
+template <typename T>
+ssize_t list_insert_after (cyclic_list<T> *lst, T val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (pos > lst->cap || pos < 0 || node_prev (lst, pos) == FREE_NODE_MARKER) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free or nonexistent node while trying to insert \
+                an element after one on position %lld, in function list_insert_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->free == FICT && !cl_resize_up (lst)) {
+
+        printf ("\nResize failed: memory error while trying to resize up \
+                from capacity %lld, in function list_insert_after ()\n", lst->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    lst->quick_mode = false;
+    return cl_ins_after (lst, pos, std::move (val));
+}
+
+template <typename T>
+DEL_FR_OPER_CODE list_delete_front (cyclic_list<T> *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_FR_VER_FAILED;
+    }
+
+#endif
+
+    if (node_next (lst, FICT) == NO_HEAD) {
+
+        return NO_HEAD_TO_DELETE;
+    }
+
+    cl_del (lst, node_next (lst, FICT));
+
+    lst->quick_mode = false;
+    return HEAD_DELETED;
+}
+
+template <typename T>
+DEL_BK_OPER_CODE list_delete_back (cyclic_list<T> *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_BK_VER_FAILED;
+    }
+
+#endif
+
+    if (node_prev (lst, FICT) == NO_TAIL) {
+
+        return NO_TAIL_TO_DELETE;
+    }
+
+    cl_del (lst, node_prev (lst, FICT));
+
+    return TAIL_DELETED;
+}
+
+template <typename T>
+DEL_OPER_CODE list_delete (cyclic_list<T> *lst, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_VER_FAILED;
+    }
+
+#endif
+
+    if (pos == FICT || pos > lst->cap || pos < 0 || node_prev (lst, pos) == FREE_NODE_MARKER) {
+
+        printf ("\nDeletion failed: *pos* argument is pointing at a fictional, free or nonexistent node while trying to delete \
+                an element on position %lld, in function list_delete ()\n",
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    cl_del (lst, pos);
+
+    lst->quick_mode = false;
+    return DELETED;
+}
+
+template <typename T>
+ssize_t list_take (cyclic_list<T> *lst, ssize_t nseq) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (nseq < 0 || nseq > lst->size) {
+
+        printf ("\nTake failed: *nseq* argument is out of the sequence's range [0; %lld] \
+                while trying to take node %lld, in function list_take ()\n",
+                lst->size, nseq);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->quick_mode) {
+
+        return nseq;
+    }
+
+    ssize_t idx = FICT;
+    for ( ; nseq > 0; -- nseq) {
+
+        idx = node_next (lst, idx);
+    }
+
+    return idx;
+}
+
+template <typename T>
+SORT_OPER_CODE list_sort (cyclic_list<T> *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (list_verify (lst) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SRT_VER_FAILED;
+    }
+
+#endif
+
+    ssize_t idx = node_next (lst, FICT), nseq = 1;
+    try {
+
+        for ( ; idx != FICT; ++ nseq) {
+
+            cl_node_swap (lst, idx, nseq);
+            idx = node_next (lst, nseq);
+        }
+
+    } catch (...) {
+
+        cl_free_rebuild (lst);          // The swaps done so far left free nodes out of the free list
+        lst->quick_mode = false;
+        throw;
+    }
+
+    lst->free = (nseq <= lst->cap) ? nseq : (ssize_t) FICT;
+    for ( ; nseq <= lst->cap; ++ nseq) {
+
+        node_prev (lst, nseq) = FREE_NODE_MARKER;
+        node_next (lst, nseq) = (nseq < lst->cap) ? (ssize_t) (nseq + 1) : (ssize_t) FICT;
+    }
+
+    lst->quick_mode = true;
+    return SORTED;
+}
+
+template <typename T>
+VERIFICATION_CODE list_verify (cyclic_list<T> *lst) {
+
+    assert (lst);
+
+    if (lst->data == NULL) {
+
+        printf ("\nVerification failed: list's *data* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+    if (lst->cap < 0) {
+
+        printf ("\nVerification failed: list's *capacity* parameter ran below zero (%lld)\n", lst->cap);
+        return CAP_FLAW;
+    }
+
+    if (lst->free < 0 || lst->free > lst->cap) {
+
+        printf ("\nVerification failed: list's *free* index is out of range (%lld)\n", lst->free);
+        return FREE_FLAW;
+    }
+
+    ssize_t nodes_handled = 0, idx = FICT;
+    do {
+
+        if (node_next (lst, idx) > lst->cap || node_next (lst, idx) < 0) {
+
+            printf ("\nVerification failed: the node next to the one \
+                    on position %lld has an impossible index: %lld (number %lld in the order of the list)\n",
+                    idx, (ssize_t) node_next (lst, idx), nodes_handled + 1);
+            return LST_IDX_FLAW;
+        }
+
+        if (node_prev (lst, node_next (lst, idx)) != idx) {
+
+            printf ("\nVerification failed: incongruity of next and prev parameters \
+                    detected during the transition from the node on position %lld to the node \
+                    on position %lld (number %lld and %lld in the order of the list)\n",
+                    idx, (ssize_t) node_next (lst, idx), nodes_handled, nodes_handled + 1);
+            return LST_SEQUENCE_FLAW;
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT && nodes_handled <= lst->cap);
+
+    if (lst->size != nodes_handled - 1) {
+
+        printf ("\nVerification failed: list's *size* parameter doesn't match \
+                the number of nodes in the list (%lld against %lld)\n",
+                lst->size, nodes_handled - 1);
+        return SIZE_FLAW;
+    }
+
+    for (idx = lst->free; idx != FICT && nodes_handled <= lst->cap; ++ nodes_handled, idx = node_next (lst, idx)) {
+
+        if (node_prev (lst, idx) != FREE_NODE_MARKER) {
+
+            printf ("\nVerification failed: the free node on position %lld has \
+                    no *free node* marker (prev: %lld)\n",
+                    idx, (ssize_t) node_prev (lst, idx));
+            return FREE_MARKER_FLAW;
+        }
+
+        if (node_next (lst, idx) > lst->cap || node_next (lst, idx) < 0) {
+
+            printf ("\nVerification failed: the free node next to the one on position %lld has \
+                    an impossible index: %lld\n",
+                    idx, (ssize_t) node_next (lst, idx));
+            return FREE_IDX_FLAW;
+        }
+    }
+
+    if (idx != FICT || nodes_handled != lst->cap + 1) {
+
+        printf ("\nVerification failed: number of nodes in main and free \
+                sequences doesn't match list's capacity (%lld against %lld)\n",
+                nodes_handled, lst->cap);
+        return INCOMPLETENESS_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+#endif
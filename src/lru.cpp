@@ -0,0 +1,147 @@
+#include "lru.hpp"
+
+CTOR_OPER_CODE lru_ctor (lru_t *cache, ssize_t cap) {
+
+    assert (cache);
+
+    if (cap < 1 || cap > MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld is out of the range [1; %lld]\n", cap, MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
+
+    if (list_ctor (&cache->lst, cap) == CTOR_MEM_ERROR) {
+
+        return CTOR_MEM_ERROR;
+    }
+
+    cache->vals = (elem_t *) calloc (cache->lst.cap + 1, sizeof (elem_t));      // The storage may round the capacity up
+
+    if (cache->vals == NULL || list_hash_on (&cache->lst) == HASH_MEM_ERROR) {
+
+        printf ("\nConstruction failed: memory error\n");
+
+        free (cache->vals);
+        list_dtor (&cache->lst);
+        return CTOR_MEM_ERROR;
+    }
+
+    cache->cap = cap;
+    cache->hits = 0;
+    cache->misses = 0;
+
+    return CONSTRUCTED;
+}
+
+void lru_dtor (lru_t *cache) {
+
+    assert (cache);
+
+    list_dtor (&cache->lst);
+
+    free (cache->vals);
+    cache->vals = (elem_t *) OS_RESERVED_ADDR;
+
+    cache->cap = -1;
+}
+
+bool lru_get (lru_t *cache, elem_t key, elem_t *val) {
+
+    assert (cache);
+    assert (val);
+
+    ssize_t pos = list_find (&cache->lst, key);
+    if (pos <= FICT || list_move_front (&cache->lst, pos) != MOVED) {
+
+        cache->misses += 1;
+        return false;
+    }
+
+    cache->hits += 1;
+
+    *val = cache->vals [pos];
+    return true;
+}
+
+/*
+The tail is evicted before the insertion, so the free
+list is never empty when list_insert_front () is called
+*/
+
+LRU_OPER_CODE lru_put (lru_t *cache, elem_t key, elem_t val) {
+
+    assert (cache);
+
+    ssize_t pos = list_find (&cache->lst, key);
+    if (pos == OPER_ERROR_VER) {
+
+        return LRU_VER_FAILED;
+    }
+
+    if (pos != FICT) {
+
+        if (list_move_front (&cache->lst, pos) != MOVED) {
+
+            return LRU_VER_FAILED;
+        }
+
+        cache->vals [pos] = val;
+        return LRU_UPDATED;
+    }
+
+    bool evicted = false;
+    if (cache->lst.size == cache->cap) {
+
+        del_tail (&cache->lst);
+        evicted = true;
+    }
+
+    pos = list_insert_front (&cache->lst, key);
+    if (pos < 0) {
+
+        return LRU_VER_FAILED;
+    }
+
+    cache->vals [pos] = val;
+    return evicted ? LRU_EVICTED : LRU_INSERTED;
+}
+
+bool lru_erase (lru_t *cache, elem_t key) {
+
+    assert (cache);
+
+    return list_delete_value (&cache->lst, key) == VAL_DELETED;
+}
+
+VERIFICATION_CODE lru_verify (lru_t *cache) {
+
+    assert (cache);
+
+    if (cache->vals == NULL) {
+
+        printf ("\nVerification failed: cache's *vals* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+    if (cache->lst.hash == NULL) {
+
+        printf ("\nVerification failed: cache's list has no value index\n");
+        return HASH_FLAW;
+    }
+
+    if (cache->cap < 1 || cache->cap > cache->lst.cap) {
+
+        printf ("\nVerification failed: cache's *capacity* parameter is out of the range \
+                [1; %lld] (%lld)\n", cache->lst.cap, cache->cap);
+        return CAP_FLAW;
+    }
+
+    if (cache->lst.size > cache->cap) {
+
+        printf ("\nVerification failed: cache holds more pairs than its capacity \
+                (%lld against %lld)\n", cache->lst.size, cache->cap);
+        return SIZE_FLAW;
+    }
+
+    return list_verify (&cache->lst);
+}
@@ -0,0 +1,50 @@
+#ifndef LRU_ACTIVE
+#define LRU_ACTIVE
+
+#include "lst.hpp"
+
+/*
+LRU cache of at most *cap* key-value pairs on top of the list.
+The list holds the keys in the order of use (the most recently
+used one is the head), its value index (see list_hash_on ()) maps
+keys to node positions, and the values are kept in *vals*, a side
+array indexed by the same positions. A hit relinks the node to the
+front with list_move_front (); inserting into a full cache evicts
+the tail and reuses its node. All the nodes are allocated by the
+constructor and the list is never compacted, shrunk or sorted,
+so positions never change and the list never grows.
+
+The list is verified automatically at its own verification level
+(lower it with list_verify_level (&cache->lst, ...) for O(1)
+operations)
+*/
+
+enum LRU_OPER_CODE {LRU_INSERTED = 0, LRU_UPDATED = 1, LRU_EVICTED = 2, LRU_VER_FAILED = 3};
+
+struct lru_t {
+
+    list_t lst;
+    elem_t *vals;
+    ssize_t cap;
+
+    ssize_t hits;
+    ssize_t misses;
+};
+
+CTOR_OPER_CODE lru_ctor (lru_t *cache, ssize_t cap);
+void lru_dtor (lru_t *cache);
+VERIFICATION_CODE lru_verify (lru_t *cache);
+
+/*
+lru_get () puts the value of *key* to *val* and marks the key
+as the most recently used one (returns false on a miss).
+lru_put () inserts or updates a pair, evicting the least
+recently used one from a full cache (LRU_EVICTED).
+lru_erase () returns false if there was no such key
+*/
+
+bool lru_get (lru_t *cache, elem_t key, elem_t *val);
+LRU_OPER_CODE lru_put (lru_t *cache, elem_t key, elem_t val);
+bool lru_erase (lru_t *cache, elem_t key);
+
+#endif
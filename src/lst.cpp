@@ -1,417 +1,821 @@
-#include "lst.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-enum RESIZE_OPER_CODE {RSZ_MEM_ERROR = 0, RESIZED = 1};
+#include "lst.hpp"
 
-static RESIZE_OPER_CODE list_resize_up (list_t *lst);
+/*
+Header page of a file-backed list (see list_ctor_mapped ()),
+the nodes start right after it. *clean* is set only while
+the file isn't mapped by anybody
+*/
+
+struct map_header_t {
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t node_size;
+    int64_t cap;
+    int64_t free;
+    int64_t untouched;
+    int64_t size;
+    int64_t lin;
+    int64_t ring_head;
+    uint8_t quick_mode;
+    uint8_t reversed;
+    uint8_t clean;
+};
+
+constexpr uint64_t MAP_MAGIC = 0x314c43594349534cull;     // "LSICYCL1"
+constexpr uint32_t MAP_VERSION = 2;
+constexpr ssize_t MAP_HEADER_SIZE = 4096;                   // A whole page, so that the nodes are page-aligned
+
+constexpr size_t HUGE_PAGE = (size_t) 2 << 20;
+
+/*
+Header of a snapshot stream (see list_save ()). With
+STREAM_PACKED in *flags* every block of elements is preceded
+by the number of elements in it and the length of its varints
+*/
+
+struct stream_header_t {
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t elem_size;
+    uint32_t flags;
+    uint32_t reserved;
+    int64_t size;
+};
+
+typedef std::make_unsigned<elem_t>::type uelem_t;
+
+constexpr uint64_t STREAM_MAGIC = 0x314d525453494c53ull;  // "SLISTRM1"
+constexpr uint32_t STREAM_VERSION = 1;
+constexpr uint32_t STREAM_PACKED = 1;
+constexpr ssize_t STREAM_BLOCK = 4096;
+constexpr unsigned ELEM_BITS = sizeof (elem_t) * CHAR_BIT;
+constexpr ssize_t VARINT_MAX = (ELEM_BITS + 6) / 7;         // Bytes in the longest varint of an element
+constexpr ssize_t BLOCK_HEADER = 2 * sizeof (uint32_t);
+
+/*
+Snapshot of the nodes for a dump: *nodes* [0] is the fictional
+node, the rest are the nodes from *lo* to *hi*
+*/
+
+struct dump_job_t {
+
+    char *file_name;
+    ssize_t lo;
+    ssize_t hi;
+    ssize_t free;
+    node_t *nodes;
+};
+
+/*
+Queue of the dumps for the background thread. *pending* counts
+the queued dumps and the one being rendered
+*/
+
+struct dump_queue_t {
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::deque<dump_job_t *> jobs;
+    ssize_t pending;
+    bool started;
+};
+
+extern char **environ;
+
+struct flaw_t {
+
+    VERIFICATION_CODE code;
+    ssize_t idx;
+};
+
+static VERIFICATION_CODE auto_verify (list_t *lst, ssize_t pos);
+static VERIFICATION_CODE verify_node (list_t *lst, ssize_t idx);
+static VERIFICATION_CODE verify_header (list_t *lst);
+static ssize_t resolve_threads (ssize_t threads);
+static bool node_is (list_t *lst, ssize_t idx, bool live);
+static ssize_t rank_chain (list_t *lst, ssize_t start, bool live, idx_t *rank, std::atomic<idx_t> *tag, ssize_t threads);
+static VERIFICATION_CODE flaw_report (list_t *lst, flaw_t *flaws, ssize_t threads);
+static ssize_t seq_node (list_t *lst, ssize_t nseq);
+static ssize_t seq_reversed (list_t *lst, ssize_t nseq);
+static void unreverse (list_t *lst);
+static void relink_after (list_t *lst, ssize_t idx, ssize_t after);
+static void linearize (list_t *lst);
+template <typename C> static void merge_sort (list_t *lst, C cmp);
+template <typename C> static ssize_t merge_runs (list_t *lst, ssize_t a, ssize_t b, C cmp);
+template <typename T> static bool radix_sort (list_t *lst);
+static ssize_t insert_front (list_t *lst, elem_t val);
+static ssize_t insert_back (list_t *lst, elem_t val);
+static ssize_t insert_before (list_t *lst, elem_t val, ssize_t pos);
+static ssize_t insert_after (list_t *lst, elem_t val, ssize_t pos);
+static DEL_FR_OPER_CODE delete_front (list_t *lst);
+static DEL_BK_OPER_CODE delete_back (list_t *lst);
+static ssize_t seq_insert_before (list_t *lst, elem_t val, ssize_t nseq);
+static ssize_t seq_insert_after (list_t *lst, elem_t val, ssize_t nseq);
+static bool ring_usable (list_t *lst);
+static void ring_ins_front (list_t *lst, elem_t val);
+static void ring_del_front (list_t *lst);
+static void ring_set (list_t *lst, ssize_t head);
+static ssize_t ring_idx (list_t *lst, ssize_t nseq);
+static ssize_t ring_next (list_t *lst, ssize_t idx);
+static ssize_t ring_prev (list_t *lst, ssize_t idx);
+static RESIZE_OPER_CODE resize_to (list_t *lst, ssize_t new_cap);
+static bool side_arrays_realloc (list_t *lst, ssize_t new_cap);
+static SHRINK_OPER_CODE shrink (list_t *lst);
+static void shrink_tick (list_t *lst);
+static ssize_t grown_cap (list_t *lst);
+static ssize_t storage_cap (ssize_t cap);
+static void list_init (list_t *lst);
+static void list_init_fields (list_t *lst);
+static bool storage_alloc (list_t *lst, ssize_t cap);
+static ssize_t storage_grow (list_t *lst, ssize_t new_cap);
+static ssize_t storage_shrink (list_t *lst, ssize_t new_cap);
+static void storage_free (list_t *lst);
+static void storage_replace (list_t *lst, list_t *fresh);
+static void *buffer_realloc (list_t *lst, void *buf, size_t copy_size, size_t new_size);
+static void buffer_free (list_t *lst, void *buf);
+static void *node_buf_alloc (list_t *lst, size_t size);
+static void *node_buf_realloc (list_t *lst, void *buf, size_t old_size, size_t copy_size, size_t new_size);
+static void node_buf_free (list_t *lst, void *buf, size_t size, bool retire);
+static size_t huge_len (size_t size);
+static void *huge_alloc (size_t size, void *ctx);
+static void *huge_grow (void *buf, size_t old_size, size_t new_size, void *ctx);
+static void huge_free (void *buf, size_t size, void *ctx);
+
+#if !defined (LIST_SEGMENTED_STORAGE) && !defined (LIST_SOA_STORAGE)
+static size_t map_len (ssize_t cap);
+static void map_store (list_t *lst, bool clean);
+static bool map_resize (list_t *lst, ssize_t new_cap);
+static void map_close (list_t *lst);
+static bool map_header_valid (map_header_t *hdr, size_t file_size);
+static OPEN_OPER_CODE list_open_mapped (list_t *lst, int fd, map_header_t *map, size_t file_size);
+#endif
+static ssize_t stream_gather (list_t *lst, ssize_t idx, elem_t *elems, ssize_t n);
+static size_t stream_pack (const elem_t *elems, ssize_t n, elem_t *last, uint8_t *bytes);
+static bool stream_unpack (const uint8_t *bytes, size_t len, elem_t *elems, ssize_t n, elem_t *last);
+static DUMP_OPER_CODE dump_snapshot (list_t *lst, const char *file_name, ssize_t pos, ssize_t radius, dump_job_t **job);
+static bool dump_render (dump_job_t *job);
+static void dump_write (dump_job_t *job, FILE *gv);
+static void dump_free (dump_job_t *job);
+static dump_queue_t *dump_queue ();
+static void dump_worker (dump_queue_t *queue);
+static node_t node_load (list_t *lst, ssize_t idx);
+static void node_store (list_t *lst, ssize_t idx, node_t node);
 static void node_swap (list_t *lst, ssize_t idx1, ssize_t idx2);
-static void ins_before (list_t *lst, ssize_t idx, elem_t val);
-static void ins_after (list_t *lst, ssize_t idx, elem_t val);
-static void del (list_t *lst, ssize_t idx);
-static void del_head (list_t *lst);
-static void del_tail (list_t *lst);
 
-#define DUMP_POSITION()                                                             \
-    do {                                                                            \
-        printf("^^^ %s : %s : %d ^^^\n", __FILE__, __PRETTY_FUNCTION__, __LINE__);  \
-    } while (0)
+static unsigned ord_rand ();
+static void ord_update (list_t *lst, ssize_t idx);
+static ssize_t ord_merge (list_t *lst, ssize_t left, ssize_t right);
+static void ord_split (list_t *lst, ssize_t root, ssize_t nseq, idx_t *left, idx_t *right);
+static ssize_t ord_rank (list_t *lst, ssize_t idx);
+static ssize_t ord_select (list_t *lst, ssize_t nseq);
+static void ord_build (list_t *lst);
+static void ord_swap (list_t *lst, ssize_t idx1, ssize_t idx2);
+static void ord_move (list_t *lst, ssize_t from, ssize_t to);
+
+static ssize_t hash_slots (ssize_t cap);
+static ssize_t hash_home (list_t *lst, elem_t val);
+static void hash_insert (list_t *lst, ssize_t idx);
+static ssize_t hash_slot (list_t *lst, ssize_t idx, elem_t val);
+static void hash_build (list_t *lst);
+static void hash_swap (list_t *lst, ssize_t idx1, ssize_t idx2);
+static void hash_move (list_t *lst, ssize_t from, ssize_t to);
+static VERIFICATION_CODE verify_hash (list_t *lst);
+static ssize_t find (list_t *lst, elem_t val);
+static ssize_t scan_range (list_t *lst, ssize_t from, ssize_t to, elem_t val);
+#ifdef LIST_SOA_STORAGE
+static ssize_t elem_scan (const elem_t *elems, ssize_t n, elem_t val);
+#endif
+
+static COMPACT_OPER_CODE compact_begin (list_t *lst);
+static void compact_end (list_t *lst);
+static ssize_t compact_step (list_t *lst, ssize_t budget, ssize_t track);
+static ssize_t compact_tick (list_t *lst, ssize_t track);
+static void compact_walk (list_t *lst);
+static void compact_move (list_t *lst, ssize_t from, ssize_t to);
+static bool compact_thread (list_t *lst);
+static void free_remove (list_t *lst, ssize_t idx);
+static void free_insert (list_t *lst, ssize_t idx, ssize_t next);
+static void free_settle (list_t *lst);
 
 CTOR_OPER_CODE list_ctor (list_t *lst, ssize_t cap /* = 8 */) {
 
     assert (lst);
 
-    lst->data = (node_t *) calloc (cap + 1, sizeof (node_t));
-    if (lst->data == NULL) {
+    list_alloc_t libc_alloc = {};
+    return list_ctor_alloc (lst, &libc_alloc, cap);
+}
+
+CTOR_OPER_CODE list_ctor_alloc (list_t *lst, const list_alloc_t *alloc, ssize_t cap /* = 8 */) {
+
+    assert (lst);
+    assert (alloc);
+    assert ((alloc->alloc && alloc->grow && alloc->free) || (!alloc->alloc && !alloc->grow && !alloc->free));
+
+    if (cap > MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld exceeds the maximum capacity %lld\n", cap, MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
+
+    lst->map = NULL;
+    lst->map_fd = -1;
+    lst->alloc = *alloc;
+
+    if (!storage_alloc (lst, cap)) {
 
         printf ("\nConstruction failed: memory error\n");
         return CTOR_MEM_ERROR;
     }
 
-    lst->data [FICT].elem = FICT_NODE_ELEM;
-    lst->data [FICT].prev = NO_TAIL;
-    lst->data [FICT].next = NO_HEAD;
+    list_init (lst);
 
-    ssize_t idx = 1;
-    if (cap != 0) {
+    return CONSTRUCTED;
+}
 
-        for ( ; idx < cap; ++ idx) {
+/*
+Everything the constructors do once the storage is there:
+all the nodes are free (and never used, so none of them
+is written), the list is empty
+*/
 
-            lst->data [idx].prev = FREE_NODE_MARKER;
-            lst->data [idx].next = idx + 1;
-        }
-        lst->data [idx].prev = FREE_NODE_MARKER;
-        lst->data [idx].next = FICT;
+static void list_init (list_t *lst) {
 
-        lst->free = 1;
+    node_elem (lst, FICT) = FICT_NODE_ELEM;
+    node_prev (lst, FICT) = NO_TAIL;
+    node_next (lst, FICT) = NO_HEAD;
 
-    } else {
+    lst->free = (lst->cap != 0) ? 1 : FICT;
+    lst->untouched = 1;
 
-        lst->free = FICT;
-    }
+    list_init_fields (lst);
+}
+
+/*
+Everything but the nodes and the free list, so that
+a mapped list can be opened over its stored nodes
+*/
+
+static void list_init_fields (list_t *lst) {
 
     lst->quick_mode = true;
-    lst->cap = cap;
 
-    return CONSTRUCTED;
+    lst->ord = NULL;
+    lst->ord_root = FICT;
+
+    lst->size = 0;
+    lst->shrink_ratio = 0;
+
+#ifdef LIST_SEGMENTED_STORAGE
+    lst->growth = {1, CHUNK_SIZE, 0};
+#else
+    lst->growth = {2, 1, 0};
+#endif
+
+    lst->lin = 0;
+    lst->cmp.fprev = NULL;
+    lst->cmp.budget = 0;
+
+    lst->ver_level = LIST_VER_LEVEL;
+    lst->ring_head = FICT;
+    lst->reversed = false;
+
+    lst->retire = NULL;
+    lst->retire_ctx = NULL;
+
+    lst->hash = NULL;
+    lst->hash_cap = 0;
 }
 
 void list_dtor (list_t *lst) {
 
     assert (lst);
 
-    memset (lst->data, 0, (lst->cap + 1) * sizeof (node_t));
-    free (lst->data);
-    lst->data = (node_t *) OS_RESERVED_ADDR;
+    storage_free (lst);
+
+    free (lst->ord);
+    lst->ord = NULL;
+    lst->ord_root = FICT;
+
+    free (lst->cmp.fprev);
+    lst->cmp.fprev = NULL;
+    lst->lin = -1;
+
+    free (lst->hash);
+    lst->hash = NULL;
+    lst->hash_cap = 0;
 
+    lst->size = -1;
     lst->cap = -1;
     lst->free = -1;
+    lst->untouched = -1;
     lst->quick_mode = false;
+    lst->ring_head = FICT;
+    lst->reversed = false;
 }
 
-ssize_t list_insert_front (list_t *lst, elem_t val) {
+CTOR_OPER_CODE list_ctor_from (list_t *lst, const elem_t *vals, ssize_t n) {
 
     assert (lst);
+    assert (vals || n == 0);
 
-#ifdef AUTO_VERIFICATION_ON
-
-    if (list_verify (lst) != NO_FLAWS) {
+    if (list_ctor (lst, n) == CTOR_MEM_ERROR) {
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
+        return CTOR_MEM_ERROR;
     }
 
-#endif
+    if (n == 0) {
 
-    if (lst->free == FICT) {
-        
-        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+        return CONSTRUCTED;
+    }
 
-            printf ("\nResize failed: memory error while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_insert_front ()\n",
-                    lst->cap, lst->cap * 2 + 1);
-            return OPER_ERROR_MEM;
-        }
+    for (ssize_t idx = 1; idx <= n; ++ idx) {
+
+        node_elem (lst, idx) = vals [idx - 1];
+        node_prev (lst, idx) = idx - 1;
+        node_next (lst, idx) = idx + 1;
     }
+    node_next (lst, n) = FICT;
 
-    ins_after (lst, FICT, val);
+    node_next (lst, FICT) = 1;
+    node_prev (lst, FICT) = n;
 
-    lst->quick_mode = false;
-    return lst->data [FICT].next;
-}
+    lst->free = (n < lst->cap) ? (ssize_t) (n + 1) : (ssize_t) FICT;
+    lst->untouched = n + 1;
+    lst->size = n;
+    lst->lin = n;
 
-ssize_t list_insert_back (list_t *lst, elem_t val) {
+    return CONSTRUCTED;
+}
 
-    assert (lst);
+#if defined (LIST_SEGMENTED_STORAGE) || defined (LIST_SOA_STORAGE)
 
-#ifdef AUTO_VERIFICATION_ON
+CTOR_OPER_CODE list_ctor_mapped (list_t *lst, const char *file_name, ssize_t cap /* = 8 */) {
 
-    if (list_verify (lst) != NO_FLAWS) {
+    assert (lst);
+    assert (file_name);
+    (void) lst;
+    (void) file_name;
+    (void) cap;
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
-    }
+    printf ("\nConstruction failed: file-backed storage needs the flat layout \
+            (no LIST_SEGMENTED_STORAGE or LIST_SOA_STORAGE)\n");
+    return CTOR_MEM_ERROR;
+}
 
-#endif
+OPEN_OPER_CODE list_open (list_t *lst, const char *file_name) {
 
-    if (lst->free == FICT) {
-        
-        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+    assert (lst);
+    assert (file_name);
+    (void) lst;
+    (void) file_name;
 
-            printf ("\nResize failed: memory error while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_insert_back ()\n",
-                    lst->cap, lst->cap * 2 + 1);
-            return OPER_ERROR_MEM;
-        }
-    }
+    printf ("\nOpening failed: file-backed storage needs the flat layout \
+            (no LIST_SEGMENTED_STORAGE or LIST_SOA_STORAGE)\n");
+    return OPEN_FILE_ERROR;
+}
 
-    ins_before (lst, FICT, val);
+void list_sync (list_t *lst) {
 
-    return lst->data [FICT].prev;
+    assert (lst);
+    (void) lst;
 }
 
-ssize_t list_insert_before (list_t *lst, elem_t val, ssize_t pos) {
+#else
+
+CTOR_OPER_CODE list_ctor_mapped (list_t *lst, const char *file_name, ssize_t cap /* = 8 */) {
 
     assert (lst);
+    assert (file_name);
 
-#ifdef AUTO_VERIFICATION_ON
+    if (cap < 0 || cap > MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld is out of the range [0; %lld]\n", cap, MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
 
-    if (list_verify (lst) != NO_FLAWS) {
+    int fd = open (file_name, O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
+        printf ("\nConstruction failed: can't create file %s\n", file_name);
+        return CTOR_MEM_ERROR;
     }
 
-#endif
+    /*
+    The file is truncated only under the lock, so a list
+    another process has open is never wiped from under it
+    */
 
-    if (lst->free == FICT) {
-        
-        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+    if (flock (fd, LOCK_EX | LOCK_NB) != 0) {
 
-            printf ("\nResize failed: memory error while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_insert_before ()\n",
-                    lst->cap, lst->cap * 2 + 1);
-            return OPER_ERROR_MEM;
-        }
+        printf ("\nConstruction failed: file %s is in use by another list\n", file_name);
+        close (fd);
+        return CTOR_MEM_ERROR;
     }
 
-    if (pos > lst->cap) {
+    void *map = MAP_FAILED;
+    if (ftruncate (fd, 0) == 0 && ftruncate (fd, (off_t) map_len (cap)) == 0) {
 
-        printf ("\nInsertion failed: *pos* argument exceeds lists capacity value while trying to insert \
-                an element before one on position %lld, in function list_insert_before ()\n",
-                pos);
-        return OPER_ERROR_INP;
+        map = mmap (NULL, map_len (cap), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     }
 
-    if (pos < 0) {
+    if (map == MAP_FAILED) {
 
-        printf ("\nInsertion failed: *pos* argument ran below zero while trying to insert \
-                an element before one on position %lld, in function list_insert_before ()\n",
-                pos);
-        return OPER_ERROR_INP;
+        printf ("\nConstruction failed: can't map %lld nodes of file %s\n", cap, file_name);
+        close (fd);
+        return CTOR_MEM_ERROR;
     }
 
-    if (lst->data [pos].prev == FREE_NODE_MARKER) {
+    lst->map = (map_header_t *) map;
+    lst->map_fd = fd;
+    lst->data = (node_t *) ((char *) map + MAP_HEADER_SIZE);
+    lst->cap = cap;
+    lst->alloc = {};
 
-        printf ("\nInsertion failed: *pos* argument is pointing at a free node while trying to insert \
-                an element before one on position %lld, in function list_insert_before ()\n",
-                pos);
-        return OPER_ERROR_INP;
-    }
+    list_init (lst);
 
-    ins_before (lst, pos, val);
+    lst->map->magic = MAP_MAGIC;
+    lst->map->version = MAP_VERSION;
+    lst->map->node_size = sizeof (node_t);
+    map_store (lst, false);
 
-    lst->quick_mode = false;
-    return lst->data [pos].prev;
+    return CONSTRUCTED;
 }
 
-ssize_t list_insert_after (list_t *lst, elem_t val, ssize_t pos) {
+OPEN_OPER_CODE list_open (list_t *lst, const char *file_name) {
 
     assert (lst);
+    assert (file_name);
 
-#ifdef AUTO_VERIFICATION_ON
-
-    if (list_verify (lst) != NO_FLAWS) {
+    int fd = open (file_name, O_RDWR);
+    if (fd == -1) {
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
+        printf ("\nOpening failed: can't open file %s\n", file_name);
+        return OPEN_FILE_ERROR;
     }
 
-#endif
-
-    if (lst->free == FICT) {
-        
-        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+    if (flock (fd, LOCK_EX | LOCK_NB) != 0) {
 
-            printf ("\nResize failed: memory error\n while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_insert_after ()\n",
-                    lst->cap, lst->cap * 2 + 1);
-            return OPER_ERROR_MEM;
-        }
+        printf ("\nOpening failed: file %s is in use by another list\n", file_name);
+        close (fd);
+        return OPEN_FILE_ERROR;
     }
 
-    if (pos > lst->cap) {
+    struct stat st = {};
+    if (fstat (fd, &st) == -1 || st.st_size < MAP_HEADER_SIZE) {
 
-        printf ("\nInsertion failed: *pos* argument exceeds lists capacity value while trying to insert \
-                an element after one on position %lld, in function list_insert_after ()\n",
-                pos);
-        return OPER_ERROR_INP;
+        printf ("\nOpening failed: file %s is too short to be a list\n", file_name);
+        close (fd);
+        return OPEN_FORMAT_ERROR;
     }
 
-    if (pos < 0) {
+    void *map = mmap (NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
 
-        printf ("\nInsertion failed: *pos* argument ran below zero while trying to insert \
-                an element after one on position %lld, in function list_insert_after ()\n",
-                pos);
-        return OPER_ERROR_INP;
+        printf ("\nOpening failed: can't map file %s\n", file_name);
+        close (fd);
+        return OPEN_FILE_ERROR;
     }
 
-    if (lst->data [pos].prev == FREE_NODE_MARKER) {
+    OPEN_OPER_CODE code = list_open_mapped (lst, fd, (map_header_t *) map, (size_t) st.st_size);
+    if (code != OPENED) {
 
-        printf ("\nInsertion failed: *pos* argument is pointing at a free node while trying to insert \
-                an element after one on position %lld, in function list_insert_after ()\n",
-                pos);
-        return OPER_ERROR_INP;
+        munmap (map, (size_t) st.st_size);
+        close (fd);
     }
 
-    ins_after (lst, pos, val);
-
-    lst->quick_mode = false;
-    return lst->data [pos].next;
+    return code;
 }
 
-DEL_FR_OPER_CODE list_delete_front (list_t *lst) {
-
-    assert (lst);
+/*
+Takes the state of the list from the header; the rest
+of list_t is set up as the constructor does it
+*/
 
-#ifdef AUTO_VERIFICATION_ON
+static OPEN_OPER_CODE list_open_mapped (list_t *lst, int fd, map_header_t *map, size_t file_size) {
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (!map_header_valid (map, file_size)) {
 
-        DUMP_POSITION();
-        return DEL_FR_VER_FAILED;
+        return OPEN_FORMAT_ERROR;
     }
 
-#endif
+    lst->map = map;
+    lst->map_fd = fd;
+    lst->data = (node_t *) ((char *) map + MAP_HEADER_SIZE);
+    lst->cap = map->cap;
+    lst->alloc = {};
 
-    if (lst->data [FICT].next == NO_HEAD) {
+    list_init_fields (lst);
 
-        return NO_HEAD_TO_DELETE;
+    lst->free = map->free;
+    lst->untouched = map->untouched;
+    lst->size = map->size;
+    lst->lin = map->lin;
+    lst->ring_head = map->ring_head;
+    lst->quick_mode = map->quick_mode;
+    lst->reversed = map->reversed;
+
+    if (!map->clean && list_verify (lst) != NO_FLAWS) {
+
+        printf ("\nOpening failed: the list wasn't closed properly and is damaged\n");
+        return OPEN_VER_FAILED;
     }
 
-    del_head (lst);
+    map->clean = false;
 
-    lst->quick_mode = false;
-    return HEAD_DELETED;
+    return OPENED;
 }
 
-DEL_BK_OPER_CODE list_delete_back (list_t *lst) {
+void list_sync (list_t *lst) {
 
     assert (lst);
 
-#ifdef AUTO_VERIFICATION_ON
-
-    if (list_verify (lst) != NO_FLAWS) {
+    if (lst->map) {
 
-        DUMP_POSITION();
-        return DEL_BK_VER_FAILED;
+        map_store (lst, false);
+        msync (lst->map, map_len (lst->cap), MS_SYNC);
     }
+}
 
 #endif
 
-    if (lst->data [FICT].prev == NO_TAIL) {
-
-        return NO_TAIL_TO_DELETE;
-    }
-
-    del_tail (lst);
-
-    return TAIL_DELETED;
-}
-
-DEL_OPER_CODE list_delete (list_t *lst, ssize_t pos) {
+SAVE_OPER_CODE list_save (list_t *lst, bool (*write) (const void *buf, size_t len, void *ctx),
+                          void *ctx, bool packed /* = false */) {
 
     assert (lst);
+    assert (write);
 
 #ifdef AUTO_VERIFICATION_ON
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
 
         DUMP_POSITION();
-        return DEL_VER_FAILED;
+        return SAVE_VER_FAILED;
     }
 
 #endif
 
-    if (pos == FICT) {
+    stream_header_t hdr = {};
+    hdr.magic = STREAM_MAGIC;
+    hdr.version = STREAM_VERSION;
+    hdr.elem_size = sizeof (elem_t);
+    hdr.flags = packed ? STREAM_PACKED : 0;
+    hdr.size = lst->size;
 
-        printf ("\nDeletion failed: *pos* argument is pointing at a base fictive node while trying to delete \
-                an element on position %lld, in function list_delete ()\n", 
-                pos);
-        return DEL_WRONG_INPUT;
-    }
+    elem_t *elems = (elem_t *) calloc (STREAM_BLOCK, sizeof (elem_t));
+    uint8_t *bytes = packed ? (uint8_t *) calloc (BLOCK_HEADER + STREAM_BLOCK * VARINT_MAX, 1) : NULL;
 
-    if (pos > lst->cap) {
+    if (elems == NULL || (packed && bytes == NULL)) {
 
-        printf ("\nDeletion failed: *pos* argument exceeds lists capacity value while trying to delete \
-                an element on position %lld, in function list_delete ()\n",
-                pos);
-        return DEL_WRONG_INPUT;
+        printf ("\nSaving failed: memory error\n");
+
+        free (elems);
+        free (bytes);
+        return SAVE_MEM_ERROR;
     }
 
-    if (pos < 0) {
+    SAVE_OPER_CODE code = write (&hdr, sizeof (hdr), ctx) ? SAVED : SAVE_IO_ERROR;
 
-        printf ("\nDeletion failed: *pos* argument ran below zero while trying to delete \
-                an element on position %lld, in function list_delete ()\n",
-                pos);
-        return DEL_WRONG_INPUT;
+    ssize_t idx = list_head (lst);
+    elem_t last = 0;
+
+    for (ssize_t left = lst->size; left > 0 && code == SAVED; ) {
+
+        ssize_t n = (left < STREAM_BLOCK) ? left : STREAM_BLOCK;
+        idx = stream_gather (lst, idx, elems, n);
+        left -= n;
+
+        bool written = packed ? write (bytes, stream_pack (elems, n, &last, bytes), ctx) :
+                                write (elems, n * sizeof (elem_t), ctx);
+        if (!written) {
+
+            code = SAVE_IO_ERROR;
+        }
     }
 
-    if (lst->data [pos].prev == FREE_NODE_MARKER) {
+    if (code == SAVE_IO_ERROR) {
 
-        printf ("\nDeletion failed: *pos* argument is pointing at a free node while trying to delete \
-                an element on position %lld, in function list_delete ()\n",
-                pos);
-        return DEL_WRONG_INPUT;
+        printf ("\nSaving failed: write error\n");
     }
 
-    del (lst, pos);
+    free (elems);
+    free (bytes);
 
-    lst->quick_mode = false;
-    return DELETED;
+    return code;
 }
 
-ssize_t list_take (list_t *lst, ssize_t nseq) {
+LOAD_OPER_CODE list_load (list_t *lst, bool (*read) (void *buf, size_t len, void *ctx), void *ctx) {
 
     assert (lst);
+    assert (read);
 
-#ifdef AUTO_VERIFICATION_ON
+    stream_header_t hdr = {};
+    if (!read (&hdr, sizeof (hdr), ctx)) {
 
-    if (list_verify (lst) != NO_FLAWS) {
+        printf ("\nLoading failed: read error\n");
+        return LOAD_IO_ERROR;
+    }
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
+    if (hdr.magic != STREAM_MAGIC || hdr.version != STREAM_VERSION || hdr.elem_size != sizeof (elem_t) ||
+        (hdr.flags & ~STREAM_PACKED) != 0 || hdr.size < 0 || hdr.size > MAX_CAP) {
+
+        printf ("\nLoading failed: the stream isn't a list snapshot of this version\n");
+        return LOAD_FORMAT_ERROR;
     }
 
-#endif
+    bool packed = hdr.flags & STREAM_PACKED;
+    ssize_t size = (ssize_t) hdr.size;
 
-    if (nseq < 0) {
+    if (list_ctor (lst, size) == CTOR_MEM_ERROR) {
 
-        printf ("\nTake failed: *nseq* argument ran below zero while trying to take \
-                an element in node %lld, in function list_take ()\n",
-                nseq);
-        return OPER_ERROR_INP;
+        return LOAD_MEM_ERROR;
     }
 
-    if (lst->quick_mode) {
+    elem_t *elems = (elem_t *) calloc (STREAM_BLOCK, sizeof (elem_t));
+    uint8_t *bytes = packed ? (uint8_t *) calloc (STREAM_BLOCK * VARINT_MAX, 1) : NULL;
+    LOAD_OPER_CODE code = LOADED;
 
-        if (lst->free) {
+    if (elems == NULL || (packed && bytes == NULL)) {
 
-            if (nseq >= lst->free) {
+        printf ("\nLoading failed: memory error\n");
+        code = LOAD_MEM_ERROR;
+    }
 
-                printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
-                        while trying to take node %lld, in function list_take ()\n",
-                        lst->free - 1, nseq);
-                return OPER_ERROR_INP;
-            }
-        } else {
+    elem_t last = 0;
 
-            if (nseq > lst->cap) {
+    for (ssize_t idx = 1; idx <= size && code == LOADED; ) {
 
-                printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
-                        while trying to take node %lld, in function list_take ()\n",
-                        lst->cap, nseq);
-                return OPER_ERROR_INP;
-            }
-        }
+        ssize_t n = (size - idx + 1 < STREAM_BLOCK) ? size - idx + 1 : STREAM_BLOCK;
 
-        return nseq;
-    }
+        if (packed) {
 
-    ssize_t idx = FICT, nodes_handled = 0;
-    do {
+            uint32_t block [2] = {};                                // Number of elements, length of the varints
 
-        if (nodes_handled == nseq) {
+            if (!read (block, sizeof (block), ctx)) {
 
-            return idx;
-        }
+                code = LOAD_IO_ERROR;
 
-        idx = lst->data [idx].next;
-        nodes_handled += 1;
+            } else if (block [0] != n || block [1] > n * VARINT_MAX) {
 
-    } while (idx != FICT);
+                code = LOAD_FORMAT_ERROR;
 
-    printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
-            while trying to take node %lld, in function list_take ()\n",
-            nodes_handled, nseq);
-    return OPER_ERROR_INP;
-}
+            } else if (!read (bytes, block [1], ctx)) {
 
-ssize_t list_seq_insert_before (list_t *lst, elem_t val, ssize_t nseq) {
+                code = LOAD_IO_ERROR;
+
+            } else if (!stream_unpack (bytes, block [1], elems, n, &last)) {
+
+                code = LOAD_FORMAT_ERROR;
+            }
+
+        } else if (!read (elems, n * sizeof (elem_t), ctx)) {
+
+            code = LOAD_IO_ERROR;
+        }
+
+        for (ssize_t i = 0; i < n && code == LOADED; ++ i, ++ idx) {
+
+            node_elem (lst, idx) = elems [i];
+            node_prev (lst, idx) = idx - 1;
+            node_next (lst, idx) = idx + 1;
+        }
+    }
+
+    free (elems);
+    free (bytes);
+
+    if (code != LOADED) {
+
+        if (code == LOAD_IO_ERROR) {
+
+            printf ("\nLoading failed: read error\n");
+
+        } else if (code == LOAD_FORMAT_ERROR) {
+
+            printf ("\nLoading failed: a block of the stream is damaged\n");
+        }
+
+        list_dtor (lst);
+        return code;
+    }
+
+    if (size != 0) {
+
+        node_next (lst, size) = FICT;
+        node_next (lst, FICT) = 1;
+        node_prev (lst, FICT) = size;
+    }
+
+    lst->free = (size < lst->cap) ? (ssize_t) (size + 1) : (ssize_t) FICT;
+    lst->untouched = size + 1;
+    lst->size = size;
+    lst->lin = size;
+
+    return LOADED;
+}
+
+/*
+The functions that depend on the direction of the list are
+thin wrappers: with the list reversed (see list_reverse ())
+front and back, before and after, and logical numbers
+counted from the head and from the tail swap places
+*/
+
+ssize_t list_insert_front (list_t *lst, elem_t val) {
+
+    assert (lst);
+
+    return lst->reversed ? insert_back (lst, val) : insert_front (lst, val);
+}
+
+ssize_t list_insert_back (list_t *lst, elem_t val) {
+
+    assert (lst);
+
+    return lst->reversed ? insert_front (lst, val) : insert_back (lst, val);
+}
+
+ssize_t list_insert_before (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+    return lst->reversed ? insert_after (lst, val, pos) : insert_before (lst, val, pos);
+}
+
+ssize_t list_insert_after (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+    return lst->reversed ? insert_before (lst, val, pos) : insert_after (lst, val, pos);
+}
+
+DEL_FR_OPER_CODE list_delete_front (list_t *lst) {
+
+    assert (lst);
+
+    return lst->reversed ? (DEL_FR_OPER_CODE) delete_back (lst) : delete_front (lst);
+}
+
+DEL_BK_OPER_CODE list_delete_back (list_t *lst) {
+
+    assert (lst);
+
+    return lst->reversed ? (DEL_BK_OPER_CODE) delete_front (lst) : delete_back (lst);
+}
+
+ssize_t list_seq_insert_before (list_t *lst, elem_t val, ssize_t nseq) {
+
+    assert (lst);
+
+    return lst->reversed ? seq_insert_after (lst, val, seq_reversed (lst, nseq)) : seq_insert_before (lst, val, nseq);
+}
+
+ssize_t list_seq_insert_after (list_t *lst, elem_t val, ssize_t nseq) {
+
+    assert (lst);
+
+    return lst->reversed ? seq_insert_before (lst, val, seq_reversed (lst, nseq)) : seq_insert_after (lst, val, nseq);
+}
+
+/*
+Logical number counted from the other end; numbers
+out of [1; size] (errors included) are left as they are
+*/
+
+static ssize_t seq_reversed (list_t *lst, ssize_t nseq) {
+
+    return (nseq > 0 && nseq <= lst->size) ? lst->size + 1 - nseq : nseq;
+}
+
+static ssize_t insert_front (list_t *lst, elem_t val) {
 
     assert (lst);
 
 #ifdef AUTO_VERIFICATION_ON
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
 
         DUMP_POSITION();
         return OPER_ERROR_VER;
@@ -419,513 +823,4936 @@ ssize_t list_seq_insert_before (list_t *lst, elem_t val, ssize_t nseq) {
 
 #endif
 
-    if (nseq < 0) {
+    if (lst->free == FICT) {
 
-        printf ("\nInsertion failed: *nseq* argument ran below zero while trying to insert \
-                node before node %lld, in function list_seq_insert_before ()\n",
-                nseq);
-        return OPER_ERROR_INP;
+        if (lst->ring_head != FICT) {
+
+            linearize (lst);            // Growth would end the ring mode, the quick mode survives it
+        }
+        
+        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+            printf ("\nResize failed: memory error while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_insert_front ()\n",
+                    lst->cap, grown_cap (lst));
+            return OPER_ERROR_MEM;
+        }
     }
-    
+
+    if (ring_usable (lst)) {
+
+        ring_ins_front (lst, val);
+
+    } else {
+
+        ins_after (lst, FICT, val);
+        lst->quick_mode = false;
+    }
+
+    return compact_tick (lst, node_next (lst, FICT));
+}
+
+static ssize_t insert_back (list_t *lst, elem_t val) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
     if (lst->free == FICT) {
+
+        if (lst->ring_head != FICT) {
+
+            linearize (lst);            // Growth would end the ring mode, the quick mode survives it
+        }
         
         if (list_resize_up (lst) == RSZ_MEM_ERROR) {
 
             printf ("\nResize failed: memory error while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_seq_insert_before ()\n",
-                    lst->cap, lst->cap * 2 + 1);
+                    from capacity %lld to capacity %lld, in function list_insert_back ()\n",
+                    lst->cap, grown_cap (lst));
+            return OPER_ERROR_MEM;
+        }
+    }
+
+    ins_before (lst, FICT, val);
+
+    return compact_tick (lst, node_prev (lst, FICT));
+}
+
+static ssize_t insert_before (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (lst->free == FICT) {
+        
+        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+            printf ("\nResize failed: memory error while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_insert_before ()\n",
+                    lst->cap, grown_cap (lst));
+            return OPER_ERROR_MEM;
+        }
+    }
+
+    if (pos > lst->cap) {
+
+        printf ("\nInsertion failed: *pos* argument exceeds lists capacity value while trying to insert \
+                an element before one on position %lld, in function list_insert_before ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (pos < 0) {
+
+        printf ("\nInsertion failed: *pos* argument ran below zero while trying to insert \
+                an element before one on position %lld, in function list_insert_before ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (node_free (lst, pos)) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free node while trying to insert \
+                an element before one on position %lld, in function list_insert_before ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    ins_before (lst, pos, val);
+
+    lst->quick_mode = false;
+    return compact_tick (lst, node_prev (lst, pos));
+}
+
+static ssize_t insert_after (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (lst->free == FICT) {
+        
+        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+            printf ("\nResize failed: memory error\n while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_insert_after ()\n",
+                    lst->cap, grown_cap (lst));
             return OPER_ERROR_MEM;
         }
     }
 
-    if (lst->quick_mode) {
+    if (pos > lst->cap) {
+
+        printf ("\nInsertion failed: *pos* argument exceeds lists capacity value while trying to insert \
+                an element after one on position %lld, in function list_insert_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (pos < 0) {
+
+        printf ("\nInsertion failed: *pos* argument ran below zero while trying to insert \
+                an element after one on position %lld, in function list_insert_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (node_free (lst, pos)) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free node while trying to insert \
+                an element after one on position %lld, in function list_insert_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    ins_after (lst, pos, val);
+
+    lst->quick_mode = false;
+    return compact_tick (lst, node_next (lst, pos));
+}
+
+static DEL_FR_OPER_CODE delete_front (list_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_FR_VER_FAILED;
+    }
+
+#endif
+
+    if (node_next (lst, FICT) == NO_HEAD) {
+
+        return NO_HEAD_TO_DELETE;
+    }
+
+    if (ring_usable (lst)) {
+
+        ring_del_front (lst);
+
+    } else {
+
+        del_head (lst);
+        lst->quick_mode = false;
+    }
+
+    compact_tick (lst, FICT);
+    shrink_tick (lst);
+    return HEAD_DELETED;
+}
+
+static DEL_BK_OPER_CODE delete_back (list_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_BK_VER_FAILED;
+    }
+
+#endif
+
+    if (node_prev (lst, FICT) == NO_TAIL) {
+
+        return NO_TAIL_TO_DELETE;
+    }
+
+    del_tail (lst);
+
+    compact_tick (lst, FICT);
+    shrink_tick (lst);
+    return TAIL_DELETED;
+}
+
+DEL_OPER_CODE list_delete (list_t *lst, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_VER_FAILED;
+    }
+
+#endif
+
+    if (pos == FICT) {
+
+        printf ("\nDeletion failed: *pos* argument is pointing at a base fictive node while trying to delete \
+                an element on position %lld, in function list_delete ()\n", 
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    if (pos > lst->cap) {
+
+        printf ("\nDeletion failed: *pos* argument exceeds lists capacity value while trying to delete \
+                an element on position %lld, in function list_delete ()\n",
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    if (pos < 0) {
+
+        printf ("\nDeletion failed: *pos* argument ran below zero while trying to delete \
+                an element on position %lld, in function list_delete ()\n",
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    if (node_free (lst, pos)) {
+
+        printf ("\nDeletion failed: *pos* argument is pointing at a free node while trying to delete \
+                an element on position %lld, in function list_delete ()\n",
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    del (lst, pos);
+
+    lst->quick_mode = false;
+    compact_tick (lst, FICT);
+    shrink_tick (lst);
+    return DELETED;
+}
+
+ssize_t list_take (list_t *lst, ssize_t nseq) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (nseq < 0) {
+
+        printf ("\nTake failed: *nseq* argument ran below zero while trying to take \
+                an element in node %lld, in function list_take ()\n",
+                nseq);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->reversed) {
+
+        nseq = seq_reversed (lst, nseq);
+    }
+
+    if (lst->quick_mode) {
+
+        if (lst->free) {
+
+            if (nseq >= lst->free) {
+
+                printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
+                        while trying to take node %lld, in function list_take ()\n",
+                        lst->free - 1, nseq);
+                return OPER_ERROR_INP;
+            }
+        } else {
+
+            if (nseq > lst->cap) {
+
+                printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
+                        while trying to take node %lld, in function list_take ()\n",
+                        lst->cap, nseq);
+                return OPER_ERROR_INP;
+            }
+        }
+
+        return nseq;
+    }
+
+    if (lst->ring_head != FICT) {
+
+        if (nseq > lst->size) {
+
+            printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to take node %lld, in function list_take ()\n",
+                    lst->size, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        return ring_idx (lst, nseq);
+    }
+
+    if (nseq <= lst->lin) {
+
+        return nseq;
+    }
+
+    if (lst->ord) {
+
+        if (nseq > lst->ord [lst->ord_root].size) {
+
+            printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to take node %lld, in function list_take ()\n",
+                    (ssize_t) lst->ord [lst->ord_root].size, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        return ord_select (lst, nseq);
+    }
+
+    ssize_t idx = FICT, nodes_handled = 0;
+    do {
+
+        if (nodes_handled == nseq) {
+
+            return idx;
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT);
+
+    printf ("\nTake failed: *nseq* argument exceeds sequence's real size (%lld) \
+            while trying to take node %lld, in function list_take ()\n",
+            nodes_handled, nseq);
+    return OPER_ERROR_INP;
+}
+
+static ssize_t seq_insert_before (list_t *lst, elem_t val, ssize_t nseq) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (nseq < 0) {
+
+        printf ("\nInsertion failed: *nseq* argument ran below zero while trying to insert \
+                node before node %lld, in function list_seq_insert_before ()\n",
+                nseq);
+        return OPER_ERROR_INP;
+    }
+    
+    if (lst->free == FICT) {
+        
+        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+            printf ("\nResize failed: memory error while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_seq_insert_before ()\n",
+                    lst->cap, grown_cap (lst));
+            return OPER_ERROR_MEM;
+        }
+    }
+
+    if (lst->quick_mode) {
+
+        if (nseq > lst->free - 1) {
+
+            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to insert node before node %lld, in function list_seq_insert_before ()\n",
+                    lst->free - 1, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        ins_before (lst, nseq, val);
+
+        lst->quick_mode = false;
+        return compact_tick (lst, node_prev (lst, nseq));
+    }
+
+    if (nseq <= lst->lin) {
+
+        ins_before (lst, nseq, val);
+
+        return compact_tick (lst, node_prev (lst, nseq));
+    }
+
+    if (lst->ord) {
+
+        if (nseq > lst->ord [lst->ord_root].size) {
+
+            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to insert node before node %lld, in function list_seq_insert_before ()\n",
+                    (ssize_t) lst->ord [lst->ord_root].size, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        ssize_t idx = ord_select (lst, nseq);
+        ins_before (lst, idx, val);
+
+        return compact_tick (lst, node_prev (lst, idx));
+    }
+
+    ssize_t idx = FICT, nodes_handled = 0;
+    do {
+
+        if (nodes_handled == nseq) {
+
+            ins_before (lst, idx, val);
+            return compact_tick (lst, node_prev (lst, idx));
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT);
+
+    printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+            while trying to insert node before node %lld, in function list_seq_insert_before ()\n",
+            nodes_handled - 1, nseq);
+    return OPER_ERROR_INP;
+}
+
+static ssize_t seq_insert_after (list_t *lst, elem_t val, ssize_t nseq) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (nseq < 0) {
+
+        printf ("\nInsertion failed: *nseq* argument ran below zero while trying to insert \
+                node after node %lld, in function list_seq_insert_after ()\n",
+                nseq);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->free == FICT) {
+        
+        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+            printf ("\nResize failed: memory error while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_seq_insert_after ()\n",
+                    lst->cap, grown_cap (lst));
+            return OPER_ERROR_MEM;
+        }
+    }
+
+    if (lst->quick_mode) {
+
+        if (nseq > lst->free - 1) {
+
+            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to insert node after node %lld, in function list_seq_insert_after ()\n",
+                    lst->free - 1, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        ins_after (lst, nseq, val);
+
+        lst->quick_mode = false;
+        return compact_tick (lst, node_next (lst, nseq));
+    }
+
+    if (nseq <= lst->lin) {
+
+        ins_after (lst, nseq, val);
+
+        return compact_tick (lst, node_next (lst, nseq));
+    }
+
+    if (lst->ord) {
+
+        if (nseq > lst->ord [lst->ord_root].size) {
+
+            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to insert node after node %lld, in function list_seq_insert_after ()\n",
+                    (ssize_t) lst->ord [lst->ord_root].size, nseq);
+            return OPER_ERROR_INP;
+        }
+
+        ssize_t idx = ord_select (lst, nseq);
+        ins_after (lst, idx, val);
+
+        return compact_tick (lst, node_next (lst, idx));
+    }
+
+    ssize_t idx = FICT, nodes_handled = 0;
+    do {
+
+        if (nodes_handled == nseq) {
+
+            ins_after (lst, idx, val);
+
+            return compact_tick (lst, node_next (lst, idx));
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT);
+
+    printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
+            while trying to insert node before node %lld, in function list_seq_insert_after ()\n",
+            nodes_handled - 1, nseq);
+    return OPER_ERROR_INP;
+}
+
+DEL_SQ_OPER_CODE list_seq_delete (list_t *lst, ssize_t nseq) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_SQ_VER_FAILED;
+    }
+
+#endif
+
+    if (lst->reversed) {
+
+        nseq = seq_reversed (lst, nseq);
+    }
+
+    if (nseq < 0) {
+
+        printf ("\nDeletion failed: *nseq* argument ran below zero while trying to delete \
+                node %lld, in function list_seq_delete ()\n",
+                nseq);
+        return DEL_SQ_WRONG_INPUT;
+    }
+
+    if (nseq == FICT) {
+
+        printf ("\nDeletion failed: *nseq* argument is pointing at a base fictive node \
+                while trying to delete node %lld, in function list_seq_delete ()\n", 
+                nseq);
+        return DEL_SQ_WRONG_INPUT;
+    }
+
+    if (lst->quick_mode) {
+
+        if (lst->free) {
+
+            if (nseq >= lst->free) {
+
+                printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                        while trying to delete node %lld, in function list_seq_delete ()\n",
+                        lst->free - 1, nseq);
+                return DEL_SQ_WRONG_INPUT;
+            }
+        } else {
+
+            if (nseq > lst->cap) {
+
+                printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                        while trying to delete node %lld, in function list_seq_delete ()\n",
+                        lst->cap, nseq);
+                return DEL_SQ_WRONG_INPUT;
+            }
+        }
+
+        del (lst, nseq);
+
+        lst->quick_mode = false;
+        compact_tick (lst, FICT);
+        shrink_tick (lst);
+        return SQ_DELETED;
+    }
+
+    if (nseq <= lst->lin) {
+
+        del (lst, nseq);
+
+        compact_tick (lst, FICT);
+        shrink_tick (lst);
+        return SQ_DELETED;
+    }
+
+    if (lst->ord) {
+
+        if (nseq > lst->ord [lst->ord_root].size) {
+
+            printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
+                    while trying to delete node %lld, in function list_seq_delete ()\n",
+                    (ssize_t) lst->ord [lst->ord_root].size, nseq);
+            return DEL_SQ_WRONG_INPUT;
+        }
+
+        del (lst, ord_select (lst, nseq));
+
+        compact_tick (lst, FICT);
+        shrink_tick (lst);
+        return SQ_DELETED;
+    }
+
+    ssize_t idx = FICT, nodes_handled = 0;
+    do {
+
+        if (nodes_handled == nseq) {
+
+            del (lst, idx);
+
+            compact_tick (lst, FICT);
+            shrink_tick (lst);
+            return SQ_DELETED;
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT);
+
+    printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
+            while trying to delete node %lld, in function list_seq_delete ()\n",
+            nodes_handled, nseq);
+    return DEL_SQ_WRONG_INPUT;
+}
+
+VERIFICATION_CODE list_verify (list_t *lst) {
+
+    assert (lst);
+
+    VERIFICATION_CODE code = verify_header (lst);
+    if (code != NO_FLAWS) {
+
+        return code;
+    }
+
+    ssize_t nodes_handled = 0, idx = FICT;
+    do {
+
+        if (nodes_handled > 0 && nodes_handled <= lst->lin && idx != nodes_handled) {
+
+            printf ("\nVerification failed: the node number %lld in the order of the list \
+                    is stored on position %lld inside the linearized prefix of length %lld\n",
+                    nodes_handled, idx, lst->lin);
+            return PREFIX_FLAW;
+        }
+
+        if (lst->ring_head != FICT && nodes_handled > 0 && idx != ring_idx (lst, nodes_handled)) {
+
+            printf ("\nVerification failed: the node number %lld in the order of the list \
+                    is stored on position %lld instead of %lld in the ring mode\n",
+                    nodes_handled, idx, ring_idx (lst, nodes_handled));
+            return RING_FLAW;
+        }
+
+        if (node_next (lst, idx) > lst->cap || node_next (lst, idx) < 0) {
+
+            printf ("\nVerification failed: the node next to the one \
+                    on position %lld has an impossible index: %lld (number %lld in the order of the list)\n",
+                    idx, (ssize_t) node_next (lst, idx), nodes_handled + 1);
+            return LST_IDX_FLAW;
+        }
+
+        if (node_next (lst, idx) >= lst->untouched) {
+
+            printf ("\nVerification failed: the node next to the one on position %lld \
+                    is on never used position %lld (number %lld in the order of the list)\n",
+                    idx, (ssize_t) node_next (lst, idx), nodes_handled + 1);
+            return UNTOUCHED_FLAW;
+        }
+
+        if (node_prev (lst, node_next (lst, idx)) != idx) {
+
+            printf ("\nVerification failed: incongruity of next and prev parameters \
+                    detected during the transition from the node on position %lld to the node \
+                    on position %lld (number %lld and %lld in the order of the list)\n",
+                    idx, (ssize_t) node_next (lst, idx), nodes_handled, nodes_handled + 1);
+            return LST_SEQUENCE_FLAW;
+        }
+
+        idx = node_next (lst, idx);
+        nodes_handled += 1;
+
+    } while (idx != FICT);
+
+    if (lst->ord && lst->ord [lst->ord_root].size != nodes_handled - 1) {
+
+        printf ("\nVerification failed: order index size doesn't match \
+                list's size (%lld against %lld)\n",
+                (ssize_t) lst->ord [lst->ord_root].size, nodes_handled - 1);
+        return ORD_FLAW;
+    }
+
+    if (lst->size != nodes_handled - 1) {
+
+        printf ("\nVerification failed: list's *size* parameter doesn't match \
+                the number of nodes in the list (%lld against %lld)\n",
+                lst->size, nodes_handled - 1);
+        return SIZE_FLAW;
+    }
+
+    if (lst->lin > nodes_handled - 1) {
+
+        printf ("\nVerification failed: linearized prefix's length exceeds \
+                list's size (%lld against %lld)\n",
+                lst->lin, nodes_handled - 1);
+        return PREFIX_FLAW;
+    }
+
+    idx = lst->free;
+    for (ssize_t free_nodes_handled = 0, prev_idx = FICT; idx != FICT;
+        ++ nodes_handled, ++ free_nodes_handled, prev_idx = idx, idx = node_next (lst, idx)) {
+
+        if (idx >= lst->untouched) {
+
+            if (idx != lst->untouched) {
+
+                printf ("\nVerification failed: the free list gets to the never used nodes on position %lld \
+                        instead of the first of them, %lld (number %lld in the order of the free list)\n",
+                        idx, lst->untouched, free_nodes_handled + 1);
+                return UNTOUCHED_FLAW;
+            }
+
+            nodes_handled += lst->cap - idx + 1;        // The rest of the free list is implicit
+            break;
+        }
+
+        if (lst->cmp.fprev && lst->cmp.walked && lst->cmp.fprev [idx] != prev_idx) {
+
+            printf ("\nVerification failed: the free node on position %lld has \
+                    a wrong back link: %lld instead of %lld (number %lld in the order of the free list)\n",
+                    idx, (ssize_t) lst->cmp.fprev [idx], prev_idx, free_nodes_handled + 1);
+            return FREE_BACK_FLAW;
+        }
+
+        if (lst->ring_head != FICT && idx != ring_idx (lst, lst->size + free_nodes_handled + 1)) {
+
+            printf ("\nVerification failed: the free node number %lld in the order of the free list \
+                    is stored on position %lld instead of %lld in the ring mode\n",
+                    free_nodes_handled + 1, idx, ring_idx (lst, lst->size + free_nodes_handled + 1));
+            return RING_FLAW;
+        }
+
+        if (node_prev (lst, idx) != FREE_NODE_MARKER) {
+
+            printf ("\nVerification failed: the free node on position %lld has \
+                    no *free node* marker (prev: %lld; number %lld in the order of the free list)\n",
+                    idx, (ssize_t) node_prev (lst, idx), free_nodes_handled + 1);
+            return FREE_MARKER_FLAW;
+        }
+
+        if (node_next (lst, idx) > lst->cap || node_next (lst, idx) < 0) {
+
+            printf ("\nVerification failed: the free node next to the one on position %lld has \
+                    an impossible index: %lld (number %lld in the order of the free list)\n",
+                    idx, (ssize_t) node_next (lst, idx), free_nodes_handled + 1);
+            return FREE_IDX_FLAW;
+        }
+    }
+
+    if (nodes_handled != lst->cap + 1) {
+
+        printf ("\nVerification failed: number of nodes in main and free \
+                sequences doesn't match list's capacity (%lld against %lld)\n",
+                nodes_handled, lst->cap);
+        return INCOMPLETENESS_FLAW;
+    }
+
+    if (lst->hash) {
+
+        return verify_hash (lst);
+    }
+
+    return NO_FLAWS;
+}
+
+/*
+The checks of list_verify () and list_verify_parallel ()
+that don't need to go over the nodes
+*/
+
+static VERIFICATION_CODE verify_header (list_t *lst) {
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+    if (lst->chunks == NULL) {
+
+        printf ("\nVerification failed: list's *chunks* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+#elif defined (LIST_SOA_STORAGE)
+
+    if (lst->elem == NULL || lst->next == NULL || lst->prev == NULL) {
+
+        printf ("\nVerification failed: one of list's *elem*, *next* and *prev* pointers is NULL\n");
+        return DATA_FLAW;
+    }
+
+#else
+
+    if (lst->data == NULL) {
+
+        printf ("\nVerification failed: list's *data* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+#endif
+
+    if (lst->cap < 0) {
+
+        printf ("\nVerification failed: list's *capacity* parameter ran below zero (%lld)\n", lst->cap);
+        return CAP_FLAW;
+    }
+
+    if (lst->free < 0) {
+
+        printf ("\nVerification failed: list's *free* index ran below zero (%lld)\n", lst->free);
+        return FREE_FLAW;
+    }
+
+    if (lst->untouched < 1 || lst->untouched > lst->cap + 1 || (lst->ring_head != FICT && lst->untouched <= lst->cap)) {
+
+        printf ("\nVerification failed: list's *untouched* position is out of range (%lld) \
+                or there are never used nodes in the ring mode\n", lst->untouched);
+        return UNTOUCHED_FLAW;
+    }
+
+    if (!((node_next (lst, FICT) > 0 && node_next (lst, FICT) <= lst->cap &&
+        node_prev (lst, FICT) > 0 && node_prev (lst, FICT) <= lst->cap) ||
+        (node_next (lst, FICT) == 0 && node_prev (lst, FICT) == 0))) {
+
+        printf ("\nVerification failed: list's fictional node has an impossible \
+                parameters combination (next: %lld; prev: %lld; list's capacity: %lld)\n",
+                (ssize_t) node_next (lst, FICT), (ssize_t) node_prev (lst, FICT), lst->cap);
+        return FICT_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+/*
+Runs *body* (thread number, lo, hi) on *threads* threads
+(the calling one included), splitting [from; to) between them
+*/
+
+template <typename F>
+static void parallel_for (ssize_t threads, ssize_t from, ssize_t to, F body) {
+
+    ssize_t chunk = (to - from + threads - 1) / threads;
+    std::vector<std::thread> workers;
+
+    for (ssize_t t = 1; t < threads; ++ t) {
+
+        ssize_t lo = from + t * chunk, hi = (lo + chunk < to) ? lo + chunk : to;
+        if (lo < hi) {
+
+            workers.emplace_back (body, t, lo, hi);
+        }
+    }
+
+    body ((ssize_t) 0, from, (from + chunk < to) ? from + chunk : to);
+
+    for (std::thread &worker : workers) {
+
+        worker.join ();
+    }
+}
+
+static ssize_t resolve_threads (ssize_t threads) {
+
+    if (threads <= 0) {
+
+        threads = (ssize_t) std::thread::hardware_concurrency ();
+    }
+
+    return (threads > 0) ? threads : 1;
+}
+
+static bool node_is (list_t *lst, ssize_t idx, bool live) {
+
+    return node_free (lst, idx) != live;
+}
+
+/*
+Parallel list ranking (sublist sampling). The chain of nodes
+(live ones if *live* is set, free ones otherwise) going from
+*start* by *next* links up to FICT (or, for the free list, up
+to the never used nodes, which aren't walked) is cut into sublists
+at sampled nodes (splitters, *start* being the first of them). Threads walk
+the sublists numbering their nodes, then the sublists are put in
+order and the numbers are shifted by the lengths of the sublists
+before. *tag* of a node is -(s + 1) for the splitter of sublist s,
+s + 1 for its other nodes and 0 for the nodes out of the chain.
+
+Returns the length of the chain, with the numbers of its nodes
+in *rank*; RANK_WRONG_NODE if the chain runs into a node of the
+other kind, RANK_BROKEN if it leaves the storage, loops or joins
+another chain (two nodes linked to the same one), RANK_NO_MEM
+if there's no memory for the sublists (*tag* isn't set then)
+*/
+
+struct sublist_t {
+
+    ssize_t head;
+    ssize_t len;
+    ssize_t next;           // The sublist that follows, -1 - the end of the chain
+    ssize_t offset;         // Number of nodes in the sublists before, -1 - out of the chain
+};
+
+constexpr ssize_t SUBLISTS_PER_THREAD = 32;
+constexpr ssize_t RANK_BROKEN = -1;
+constexpr ssize_t RANK_WRONG_NODE = -2;
+constexpr ssize_t RANK_NO_MEM = -3;
+
+static ssize_t rank_chain (list_t *lst, ssize_t start, bool live, idx_t *rank, std::atomic<idx_t> *tag, ssize_t threads) {
+
+    ssize_t tail = (!live && lst->untouched <= lst->cap) ? lst->untouched : (ssize_t) FICT;
+
+    if (start == FICT || start == tail) {
+
+        return 0;
+    }
+
+    if (start < 0 || start >= lst->untouched) {
+
+        return RANK_BROKEN;
+    }
+
+    if (!node_is (lst, start, live)) {
+
+        return RANK_WRONG_NODE;
+    }
+
+    sublist_t *subs = (sublist_t *) calloc (threads * SUBLISTS_PER_THREAD, sizeof (sublist_t));
+    if (subs == NULL) {
+
+        return RANK_NO_MEM;
+    }
+
+    parallel_for (threads, 0, lst->cap + 1, [tag] (ssize_t, ssize_t lo, ssize_t hi) {
+
+        for (ssize_t idx = lo; idx < hi; ++ idx) {
+
+            tag [idx].store (0, std::memory_order_relaxed);
+        }
+    });
+
+    ssize_t n_subs = 0;
+    subs [n_subs ++].head = start;
+    tag [start].store (-1, std::memory_order_relaxed);
+
+    for (ssize_t tries = 0; tries < threads * SUBLISTS_PER_THREAD * 4 && n_subs < threads * SUBLISTS_PER_THREAD; ++ tries) {
+
+        ssize_t idx = (ssize_t) (((size_t) ord_rand () << 31 ^ ord_rand ()) % lst->cap) + 1;
+
+        if (idx < lst->untouched && node_is (lst, idx, live) && tag [idx].load (std::memory_order_relaxed) == 0) {
+
+            tag [idx].store (-(n_subs + 1), std::memory_order_relaxed);
+            subs [n_subs ++].head = idx;
+        }
+    }
+
+    std::atomic<ssize_t> taken (0);
+    std::atomic<ssize_t> fail (0);
+
+    parallel_for (threads, 0, threads, [lst, live, tail, rank, tag, subs, n_subs, &taken, &fail] (ssize_t, ssize_t, ssize_t) {
+
+        for (ssize_t sub = taken.fetch_add (1); sub < n_subs && fail.load (std::memory_order_relaxed) == 0;
+             sub = taken.fetch_add (1)) {
+
+            ssize_t idx = subs [sub].head, len = 1;
+            rank [idx] = 1;
+            subs [sub].next = -1;
+
+            for (ssize_t next = node_next (lst, idx); next != FICT && next != tail; next = node_next (lst, idx)) {
+
+                if (next < 0 || next >= lst->untouched) {
+
+                    fail.store (RANK_BROKEN);
+                    break;
+                }
+
+                if (!node_is (lst, next, live)) {
+
+                    fail.store (RANK_WRONG_NODE);
+                    break;
+                }
+
+                ssize_t next_tag = tag [next].load (std::memory_order_relaxed);
+                if (next_tag < 0) {
+
+                    subs [sub].next = -next_tag - 1;
+                    break;
+                }
+
+                if (tag [next].exchange ((idx_t) (sub + 1), std::memory_order_relaxed) != 0) {
+
+                    fail.store (RANK_BROKEN);
+                    break;
+                }
+
+                rank [next] = (idx_t) ++ len;
+                idx = next;
+            }
+
+            subs [sub].len = len;
+        }
+    });
+
+    ssize_t total = fail.load ();
+
+    if (total == 0) {
+
+        for (ssize_t sub = 0; sub < n_subs; ++ sub) {
+
+            subs [sub].offset = -1;
+        }
+
+        for (ssize_t sub = 0; sub != -1; sub = subs [sub].next) {
+
+            if (subs [sub].offset != -1) {
+
+                total = RANK_BROKEN;
+                break;
+            }
+
+            subs [sub].offset = total;
+            total += subs [sub].len;
+        }
+    }
+
+    if (total >= 0) {
+
+        parallel_for (threads, 1, lst->cap + 1, [rank, tag, subs] (ssize_t, ssize_t lo, ssize_t hi) {
+
+            for (ssize_t idx = lo; idx < hi; ++ idx) {
+
+                ssize_t sub = tag [idx].load (std::memory_order_relaxed);
+                if (sub == 0) {
+
+                    continue;
+                }
+
+                sub = ((sub < 0) ? -sub : sub) - 1;
+                if (subs [sub].offset == -1) {
+
+                    tag [idx].store (0, std::memory_order_relaxed);
+
+                } else {
+
+                    rank [idx] += (idx_t) subs [sub].offset;
+                }
+            }
+        });
+    }
+
+    free (subs);
+    return total;
+}
+
+SORT_OPER_CODE list_sort_parallel (list_t *lst, ssize_t threads /* = 0 */) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SRT_VER_FAILED;
+    }
+
+#endif
+
+    threads = resolve_threads (threads);
+
+    idx_t *rank = NULL;
+    std::atomic<idx_t> *tag = NULL;
+    list_t fresh = {};
+    fresh.alloc = lst->alloc;
+
+    if (threads > 1 && lst->size >= PARALLEL_MIN_SIZE) {
+
+        rank = (idx_t *) calloc (lst->cap + 1, sizeof (idx_t));
+        tag = new (std::nothrow) std::atomic<idx_t> [lst->cap + 1];
+    }
+
+    if (rank == NULL || tag == NULL || lst->map || !storage_alloc (&fresh, lst->cap)) {
+
+        free (rank);
+        delete [] tag;
+
+        if (lst->reversed) {                                    // Sequential sorting (too few threads or nodes, no memory or a file-backed list)
+
+            unreverse (lst);
+        }
+
+        linearize (lst);
+        return SORTED;
+    }
+
+    ssize_t size = lst->size, cap = lst->cap;
+    bool reversed = lst->reversed;
+
+    ssize_t ranked = rank_chain (lst, node_next (lst, FICT), true, rank, tag, threads);
+    if (ranked != size) {                                       // Scattering by the ranks would lose elements
+
+        free (rank);
+        delete [] tag;
+        storage_free (&fresh);
+
+        if (ranked != RANK_NO_MEM) {
+
+            printf ("\nSorting failed: the list's sequence of nodes is broken \
+                    or doesn't match list's *size* parameter (%lld)\n", size);
+            DUMP_POSITION();
+            return SRT_VER_FAILED;
+        }
+
+        if (lst->reversed) {
+
+            unreverse (lst);
+        }
+
+        linearize (lst);
+        return SORTED;
+    }
+
+    parallel_for (threads, 1, cap + 1, [lst, &fresh, rank, tag, size, reversed] (ssize_t, ssize_t lo, ssize_t hi) {
+
+        for (ssize_t idx = lo; idx < hi; ++ idx) {
+
+            if (tag [idx].load (std::memory_order_relaxed) != 0) {
+
+                node_elem (&fresh, reversed ? size + 1 - rank [idx] : rank [idx]) = node_elem (lst, idx);
+            }
+        }
+    });
+
+    parallel_for (threads, 1, size + 1, [&fresh, size] (ssize_t, ssize_t lo, ssize_t hi) {
+
+        for (ssize_t idx = lo; idx < hi; ++ idx) {
+
+            node_next (&fresh, idx) = (idx < size) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+            node_prev (&fresh, idx) = idx - 1;
+        }
+    });
+
+    node_elem (&fresh, FICT) = FICT_NODE_ELEM;
+    node_next (&fresh, FICT) = (size != 0) ? 1 : FICT;
+    node_prev (&fresh, FICT) = size;
+
+    free (rank);
+    delete [] tag;
+
+    storage_replace (lst, &fresh);
+
+    lst->free = (size < cap) ? (ssize_t) (size + 1) : (ssize_t) FICT;
+    lst->untouched = size + 1;                          // The free nodes are left as the new storage has them
+    lst->reversed = false;
+
+    if (lst->ord) {
+
+        ord_build (lst);
+    }
+
+    if (lst->hash) {
+
+        hash_build (lst);
+    }
+
+    if (lst->cmp.fprev) {
+
+        compact_end (lst);
+    }
+
+    lst->lin = size;
+    lst->quick_mode = true;
+    lst->ring_head = FICT;
+    return SORTED;
+}
+
+/*
+Every thread keeps the first flaw found in its part of the
+nodes; the one on the smallest position is printed
+*/
+
+static VERIFICATION_CODE flaw_report (list_t *lst, flaw_t *flaws, ssize_t threads) {
+
+    flaw_t *first = NULL;
+    for (ssize_t t = 0; t < threads; ++ t) {
+
+        if (flaws [t].code != NO_FLAWS && (first == NULL || flaws [t].idx < first->idx)) {
+
+            first = &flaws [t];
+        }
+    }
+
+    if (first == NULL) {
+
+        return NO_FLAWS;
+    }
+
+    ssize_t idx = first->idx;
+
+    switch (first->code) {
+
+        case LST_IDX_FLAW:
+
+            printf ("\nVerification failed: the node next to the one \
+                    on position %lld has an impossible index: %lld\n",
+                    idx, (ssize_t) node_next (lst, idx));
+            break;
+
+        case LST_SEQUENCE_FLAW:
+
+            printf ("\nVerification failed: incongruity of next and prev parameters \
+                    detected during the transition from the node on position %lld to the node \
+                    on position %lld\n",
+                    idx, (ssize_t) node_next (lst, idx));
+            break;
+
+        case FREE_IDX_FLAW:
+
+            printf ("\nVerification failed: the free node next to the one on position %lld has \
+                    an impossible index: %lld\n",
+                    idx, (ssize_t) node_next (lst, idx));
+            break;
+
+        case PREFIX_FLAW:
+
+            printf ("\nVerification failed: the node on position %lld is out of its place \
+                    inside the linearized prefix of length %lld\n",
+                    idx, lst->lin);
+            break;
+
+        case RING_FLAW:
+
+            printf ("\nVerification failed: the node on position %lld is out of its place in the ring mode\n", idx);
+            break;
+
+        case FREE_BACK_FLAW:
+
+            printf ("\nVerification failed: the free node on position %lld has \
+                    a wrong back link: %lld\n",
+                    idx, (ssize_t) lst->cmp.fprev [idx]);
+            break;
+
+        case UNTOUCHED_FLAW:
+
+            printf ("\nVerification failed: the node next to the one on position %lld \
+                    is on never used position %lld (the first of them is %lld)\n",
+                    idx, (ssize_t) node_next (lst, idx), lst->untouched);
+            break;
+
+        case INCOMPLETENESS_FLAW:
+
+            printf ("\nVerification failed: the node on position %lld is \
+                    neither in the main sequence nor in the free one\n", idx);
+            break;
+
+        default:
+
+            printf ("\nVerification failed: flaw %d on position %lld\n", (int) first->code, idx);
+            break;
+    }
+
+    return first->code;
+}
+
+VERIFICATION_CODE list_verify_parallel (list_t *lst, ssize_t threads /* = 0 */) {
+
+    assert (lst);
+
+    threads = resolve_threads (threads);
+    if (threads == 1 || lst->cap < PARALLEL_MIN_SIZE) {
+
+        return list_verify (lst);
+    }
+
+    VERIFICATION_CODE code = verify_header (lst);
+    if (code != NO_FLAWS) {
+
+        return code;
+    }
+
+    idx_t *rank = (idx_t *) calloc (lst->cap + 1, sizeof (idx_t));
+    std::atomic<idx_t> *tag = new (std::nothrow) std::atomic<idx_t> [lst->cap + 1];
+    flaw_t *flaws = (flaw_t *) calloc (threads, sizeof (flaw_t));
+
+    if (rank == NULL || tag == NULL || flaws == NULL) {
+
+        free (rank);
+        delete [] tag;
+        free (flaws);
+
+        return list_verify (lst);
+    }
+
+    /*
+    Links: every live node's neighbours link back to it, every
+    free node's *next* is inside the storage. The never used
+    nodes aren't read: live nodes mustn't link to them, free
+    ones may only link to the first of them
+    */
+
+    parallel_for (threads, 0, lst->untouched, [lst, flaws] (ssize_t t, ssize_t lo, ssize_t hi) {
+
+        for (ssize_t idx = lo; idx < hi && flaws [t].code == NO_FLAWS; ++ idx) {
+
+            ssize_t next = node_next (lst, idx);
+            bool live = idx == FICT || node_prev (lst, idx) != FREE_NODE_MARKER;
+
+            if (next < 0 || next > lst->cap) {
+
+                flaws [t] = {live ? LST_IDX_FLAW : FREE_IDX_FLAW, idx};
+
+            } else if (live ? next >= lst->untouched : next > lst->untouched) {
+
+                flaws [t] = {UNTOUCHED_FLAW, idx};
+
+            } else if (live && node_prev (lst, next) != idx) {
+
+                flaws [t] = {LST_SEQUENCE_FLAW, idx};
+            }
+        }
+    });
+
+    code = flaw_report (lst, flaws, threads);
+
+    /*
+    With consistent links, the live nodes form cycles;
+    the one with the fictional node is the list
+    */
+
+    ssize_t size = 0;
+    if (code == NO_FLAWS) {
+
+        size = rank_chain (lst, node_next (lst, FICT), true, rank, tag, threads);
+
+        if (size == RANK_NO_MEM) {
+
+            free (rank);
+            delete [] tag;
+            free (flaws);
+
+            return list_verify (lst);
+        }
+
+        if (size < 0) {
+
+            printf ("\nVerification failed: the list's sequence of nodes is broken\n");
+            code = LST_SEQUENCE_FLAW;
+
+        } else if (lst->ord && lst->ord [lst->ord_root].size != size) {
+
+            printf ("\nVerification failed: order index size doesn't match \
+                    list's size (%lld against %lld)\n",
+                    (ssize_t) lst->ord [lst->ord_root].size, size);
+            code = ORD_FLAW;
+
+        } else if (lst->size != size) {
+
+            printf ("\nVerification failed: list's *size* parameter doesn't match \
+                    the number of nodes in the list (%lld against %lld)\n",
+                    lst->size, size);
+            code = SIZE_FLAW;
+
+        } else if (lst->lin > size) {
+
+            printf ("\nVerification failed: linearized prefix's length exceeds \
+                    list's size (%lld against %lld)\n",
+                    lst->lin, size);
+            code = PREFIX_FLAW;
+        }
+    }
+
+    if (code == NO_FLAWS) {
+
+        parallel_for (threads, 1, lst->untouched, [lst, rank, tag, flaws] (ssize_t t, ssize_t lo, ssize_t hi) {
+
+            for (ssize_t idx = lo; idx < hi && flaws [t].code == NO_FLAWS; ++ idx) {
+
+                if (node_prev (lst, idx) == FREE_NODE_MARKER) {
+
+                    continue;
+                }
+
+                if (tag [idx].load (std::memory_order_relaxed) == 0) {
+
+                    flaws [t] = {INCOMPLETENESS_FLAW, idx};
+
+                } else if (rank [idx] <= lst->lin && idx != rank [idx]) {
+
+                    flaws [t] = {PREFIX_FLAW, idx};
+
+                } else if (lst->ring_head != FICT && idx != ring_idx (lst, rank [idx])) {
+
+                    flaws [t] = {RING_FLAW, idx};
+                }
+            }
+        });
+
+        code = flaw_report (lst, flaws, threads);
+    }
+
+    /*
+    The free list: the same ranking of its written part (the never
+    used nodes are its implicit tail), then positions in the ring
+    mode and back links of the compaction
+    */
+
+    ssize_t n_untouched = lst->cap + 1 - lst->untouched;
+
+    if (code == NO_FLAWS) {
+
+        ssize_t n_free = rank_chain (lst, lst->free, false, rank, tag, threads);
+        if (n_free == RANK_NO_MEM) {
+
+            free (rank);
+            delete [] tag;
+            free (flaws);
+
+            return list_verify (lst);
+        }
+
+        if (n_free >= 0) {
+
+            n_free += n_untouched;
+        }
+
+        if (n_free == RANK_WRONG_NODE) {
+
+            printf ("\nVerification failed: a node without the *free node* marker is in the free list\n");
+            code = FREE_MARKER_FLAW;
+
+        } else if (n_free < 0) {
+
+            printf ("\nVerification failed: the free list is broken\n");
+            code = FREE_IDX_FLAW;
+
+        } else if (size + n_free != lst->cap) {
+
+            printf ("\nVerification failed: number of nodes in main and free \
+                    sequences doesn't match list's capacity (%lld against %lld)\n",
+                    size + n_free + 1, lst->cap);
+            code = INCOMPLETENESS_FLAW;
+
+        } else if (n_untouched > 0 && lst->free == FICT) {
+
+            flaws [0] = {INCOMPLETENESS_FLAW, lst->untouched};
+            code = flaw_report (lst, flaws, 1);
+
+        } else if (lst->cmp.fprev && lst->cmp.walked && lst->free != FICT && lst->cmp.fprev [lst->free] != FICT) {
+
+            flaws [0] = {FREE_BACK_FLAW, lst->free};
+            code = flaw_report (lst, flaws, 1);
+        }
+    }
+
+    if (code == NO_FLAWS) {
+
+        parallel_for (threads, 1, lst->untouched, [lst, rank, flaws, size, n_untouched] (ssize_t t, ssize_t lo, ssize_t hi) {
+
+            for (ssize_t idx = lo; idx < hi && flaws [t].code == NO_FLAWS; ++ idx) {
+
+                if (node_prev (lst, idx) != FREE_NODE_MARKER) {
+
+                    continue;
+                }
+
+                ssize_t next = node_next (lst, idx);
+
+                if (next == FICT && n_untouched > 0) {                  // The free list ends before the never used nodes
+
+                    flaws [t] = {INCOMPLETENESS_FLAW, lst->untouched};
+
+                } else if (lst->ring_head != FICT && idx != ring_idx (lst, size + rank [idx])) {
+
+                    flaws [t] = {RING_FLAW, idx};
+
+                } else if (lst->cmp.fprev && lst->cmp.walked && next != FICT && next < lst->untouched && lst->cmp.fprev [next] != idx) {
+
+                    flaws [t] = {FREE_BACK_FLAW, next};
+                }
+            }
+        });
+
+        code = flaw_report (lst, flaws, threads);
+    }
+
+    if (code == NO_FLAWS && lst->hash) {
+
+        code = verify_hash (lst);
+    }
+
+    free (rank);
+    delete [] tag;
+    free (flaws);
+
+    return code;
+}
+
+ssize_t list_insert_span_after (list_t *lst, const elem_t *vals, ssize_t n, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    if (n < 0 || (n > 0 && vals == NULL)) {
+
+        printf ("\nInsertion failed: wrong span (%lld elements at %p) while trying to insert \
+                it after the node on position %lld, in function list_insert_span_after ()\n",
+                n, (const void *) vals, pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (pos > lst->cap || pos < 0 || node_free (lst, pos)) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free or nonexistent node while trying to insert \
+                a span after one on position %lld, in function list_insert_span_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (lst->cap - lst->size < n) {
+
+        ssize_t new_cap = (lst->size + n > grown_cap (lst)) ? lst->size + n : grown_cap (lst);
+
+        if (resize_to (lst, new_cap) == RSZ_MEM_ERROR || lst->cap - lst->size < n) {
+
+            printf ("\nResize failed: memory error while trying to resize up \
+                    from capacity %lld to capacity %lld, in function list_insert_span_after ()\n",
+                    lst->cap, new_cap);
+            return OPER_ERROR_MEM;
+        }
+    }
+
+    if (lst->reversed) {
+
+        /*
+        Logically after *pos* is physically before it,
+        so the span is laid out backwards
+        */
+
+        if (n != 0) {
+
+            lst->quick_mode = false;
+        }
+
+        ssize_t idx = pos;
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            ins_before (lst, idx, vals [i]);
+            idx = node_prev (lst, idx);
+        }
+
+        return compact_tick (lst, (n != 0) ? node_prev (lst, pos) : pos);
+    }
+
+    if (pos != node_prev (lst, FICT)) {
+
+        lst->quick_mode = false;
+    }
+
+    ssize_t idx = pos;
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        ins_after (lst, idx, vals [i]);
+        idx = node_next (lst, idx);
+    }
+
+    return compact_tick (lst, (n != 0) ? node_next (lst, pos) : pos);
+}
+
+DEL_SQ_OPER_CODE list_seq_delete_range (list_t *lst, ssize_t from, ssize_t to) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_SQ_VER_FAILED;
+    }
+
+#endif
+
+    if (from < 1 || to < from || to > lst->size + 1) {
+
+        printf ("\nDeletion failed: range [%lld; %lld) is out of the sequence's range [1; %lld] \
+                while trying to delete it, in function list_seq_delete_range ()\n",
+                from, to, lst->size);
+        return DEL_SQ_WRONG_INPUT;
+    }
+
+    if (lst->reversed) {
+
+        ssize_t rev_from = lst->size + 2 - to;
+        to = lst->size + 2 - from;
+        from = rev_from;
+    }
+
+    if (to != lst->size + 1) {
+
+        lst->quick_mode = false;
+    }
+
+    /*
+    Deleting from the back of the range: when it is a suffix
+    of a list in the quick mode, the nodes are pushed to the free
+    list in descending order, so it stays an ascending run
+    */
+
+    ssize_t idx = seq_node (lst, to - 1);
+    for (ssize_t count = to - from; count > 0; -- count) {
+
+        ssize_t prev = node_prev (lst, idx);
+        del (lst, idx);
+        idx = prev;
+    }
+
+    compact_tick (lst, FICT);
+    shrink_tick (lst);
+    return SQ_DELETED;
+}
+
+ROTATE_OPER_CODE list_rotate (list_t *lst, ssize_t k) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return ROT_VER_FAILED;
+    }
+
+#endif
+
+    if (lst->size == 0) {
+
+        return ROTATED;
+    }
+
+    if (lst->reversed) {
+
+        k = -k;
+    }
+
+    k %= lst->size;
+    if (k < 0) {
+
+        k += lst->size;
+    }
+
+    if (k == 0) {
+
+        return ROTATED;
+    }
+
+    ssize_t new_tail = seq_node (lst, k);
+    ssize_t new_head = node_next (lst, new_tail);
+    ssize_t old_head = node_next (lst, FICT), old_tail = node_prev (lst, FICT);
+
+    node_next (lst, old_tail) = old_head;
+    node_prev (lst, old_head) = old_tail;
+
+    node_next (lst, new_tail) = FICT;
+    node_prev (lst, new_head) = FICT;
+    node_next (lst, FICT) = new_head;
+    node_prev (lst, FICT) = new_tail;
+
+    if (lst->ord) {
+
+        idx_t left = FICT, right = FICT;
+        ord_split (lst, lst->ord_root, k, &left, &right);
+
+        lst->ord_root = ord_merge (lst, right, left);
+        lst->ord [lst->ord_root].parent = FICT;
+    }
+
+    /*
+    A full list has no free nodes to keep in order,
+    so a rotated quick mode or ring is still a ring
+    */
+
+    if (lst->free == FICT && ring_usable (lst)) {
+
+        ring_set (lst, new_head);
+
+    } else {
+
+        lst->quick_mode = false;
+        lst->ring_head = FICT;
+    }
+
+    if (!lst->quick_mode) {
+
+        lst->lin = 0;
+    }
+
+    compact_tick (lst, FICT);
+    return ROTATED;
+}
+
+void list_retire_hook (list_t *lst, void (*retire) (void *buf, void *ctx), void *ctx) {
+
+    assert (lst);
+    assert (lst->alloc.free == NULL);
+
+    lst->retire = retire;
+    lst->retire_ctx = ctx;
+}
+
+void list_reverse (list_t *lst) {
+
+    assert (lst);
+
+    lst->reversed = !lst->reversed;
+}
+
+MOVE_OPER_CODE list_move_front (list_t *lst, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return MOV_VER_FAILED;
+    }
+
+#endif
+
+    if (pos == FICT) {
+
+        printf ("\nMove failed: *pos* argument is pointing at a base fictive node while trying to move \
+                an element on position %lld, in function list_move_front ()\n",
+                pos);
+        return MOV_WRONG_INPUT;
+    }
+
+    if (pos > lst->cap) {
+
+        printf ("\nMove failed: *pos* argument exceeds lists capacity value while trying to move \
+                an element on position %lld, in function list_move_front ()\n",
+                pos);
+        return MOV_WRONG_INPUT;
+    }
+
+    if (pos < 0) {
+
+        printf ("\nMove failed: *pos* argument ran below zero while trying to move \
+                an element on position %lld, in function list_move_front ()\n",
+                pos);
+        return MOV_WRONG_INPUT;
+    }
+
+    if (node_free (lst, pos)) {
+
+        printf ("\nMove failed: *pos* argument is pointing at a free node while trying to move \
+                an element on position %lld, in function list_move_front ()\n",
+                pos);
+        return MOV_WRONG_INPUT;
+    }
+
+    relink_after (lst, pos, lst->reversed ? (ssize_t) node_prev (lst, FICT) : (ssize_t) FICT);
+
+    compact_tick (lst, FICT);
+    return MOVED;
+}
+
+/*
+Unlinks the live node *idx* and links it back right
+after the node *after*. The size and the value index
+don't change; the linearized prefix is cut short where
+the node left it or where it was put
+*/
+
+static void relink_after (list_t *lst, ssize_t idx, ssize_t after) {
+
+    if (idx == after || node_prev (lst, idx) == after) {
+
+        return;
+    }
+
+    if (lst->ord) {
+
+        ord_unlink (lst, idx);
+    }
+
+    node_prev (lst, node_next (lst, idx)) = node_prev (lst, idx);
+    node_next (lst, node_prev (lst, idx)) = node_next (lst, idx);
+
+    node_prev (lst, idx) = after;
+    node_next (lst, idx) = node_next (lst, after);
+    node_prev (lst, node_next (lst, after)) = idx;
+    node_next (lst, after) = idx;
+
+    if (lst->ord) {
+
+        ord_link (lst, idx);
+    }
+
+    if (idx <= lst->lin) {
+
+        lst->lin = idx - 1;
+    }
+
+    if (after < lst->lin) {
+
+        lst->lin = after;
+    }
+
+    lst->quick_mode = false;
+    lst->ring_head = FICT;
+}
+
+/*
+Makes the physical order of the links match the logical
+one: the links of every live node (and the fictional one) are
+swapped. Positions don't change, but the quick mode, the ring,
+the linearized prefix and the order index don't survive that
+*/
+
+static void unreverse (list_t *lst) {
+
+    ssize_t idx = FICT;
+    do {
+
+        ssize_t next = node_next (lst, idx);
+        node_next (lst, idx) = node_prev (lst, idx);
+        node_prev (lst, idx) = next;
+        idx = next;
+
+    } while (idx != FICT);
+
+    lst->reversed = false;
+    lst->quick_mode = false;
+    lst->ring_head = FICT;
+    lst->lin = 0;
+}
+
+/*
+Position of the node with logical number *nseq* (which
+must be in [0; size]), found the fastest available way
+*/
+
+static ssize_t seq_node (list_t *lst, ssize_t nseq) {
+
+    if (lst->quick_mode || nseq <= lst->lin) {
+
+        return nseq;
+    }
+
+    if (lst->ring_head != FICT) {
+
+        return ring_idx (lst, nseq);
+    }
+
+    if (lst->ord) {
+
+        return ord_select (lst, nseq);
+    }
+
+    ssize_t idx = FICT;
+    if (nseq > lst->size / 2) {
+
+        for (ssize_t count = lst->size - nseq + 1; count > 0; -- count) {
+
+            idx = node_prev (lst, idx);
+        }
+
+    } else {
+
+        for (ssize_t count = nseq; count > 0; -- count) {
+
+            idx = node_next (lst, idx);
+        }
+    }
+
+    return idx;
+}
+
+/*
+Ring mode (see list_t): the ends of the list can be handled
+in O(1) without leaving it only while nothing else (compaction
+in the first place) relies on the free list's order
+*/
+
+static bool ring_usable (list_t *lst) {
+
+    return (lst->quick_mode || lst->ring_head != FICT) && lst->cmp.fprev == NULL;
+}
+
+/*
+The new head is the position right before the current one,
+which is the tail of the free list (there must be a free node)
+*/
+
+static void ring_ins_front (list_t *lst, elem_t val) {
+
+    if (lst->untouched <= lst->cap) {
+
+        free_settle (lst);                  // The free list gets linked cyclically
+    }
+
+    ssize_t idx = ring_prev (lst, (lst->ring_head != FICT) ? lst->ring_head : 1);
+
+    if (lst->free == idx) {
+
+        lst->free = FICT;
+
+    } else {
+
+        node_next (lst, ring_prev (lst, idx)) = FICT;
+    }
+
+    node_elem (lst, idx) = val;
+    node_prev (lst, idx) = FICT;
+    node_next (lst, idx) = node_next (lst, FICT);
+    node_prev (lst, node_next (lst, FICT)) = idx;
+    node_next (lst, FICT) = idx;
+
+    node_linked (lst, idx);
+    ring_set (lst, idx);
+}
+
+/*
+The old head becomes the tail of the free list, which
+ends right before it
+*/
+
+static void ring_del_front (list_t *lst) {
+
+    if (lst->untouched <= lst->cap) {
+
+        free_settle (lst);
+    }
+
+    ssize_t idx = node_next (lst, FICT);
+
+    node_unlinked (lst, idx);
+
+    node_prev (lst, node_next (lst, idx)) = FICT;
+    node_next (lst, FICT) = node_next (lst, idx);
+
+    node_elem (lst, idx) = FREE_NODE_ELEM;
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = FICT;
+
+    if (lst->free == FICT) {
+
+        lst->free = idx;
+
+    } else {
+
+        node_next (lst, ring_prev (lst, idx)) = idx;
+    }
+
+    ring_set (lst, ring_next (lst, idx));
+}
+
+/*
+A ring with its head on position 1 is the quick mode
+*/
+
+static void ring_set (list_t *lst, ssize_t head) {
+
+    if (head == 1) {
+
+        lst->ring_head = FICT;
+        lst->quick_mode = true;
+        lst->lin = lst->size;
+
+    } else {
+
+        lst->ring_head = head;
+        lst->quick_mode = false;
+    }
+}
+
+static ssize_t ring_idx (list_t *lst, ssize_t nseq) {
+
+    if (nseq == 0) {
+
+        return FICT;
+    }
+
+    ssize_t idx = lst->ring_head + nseq - 1;
+
+    return (idx > lst->cap) ? idx - lst->cap : idx;
+}
+
+static ssize_t ring_next (list_t *lst, ssize_t idx) {
+
+    return (idx == lst->cap) ? 1 : idx + 1;
+}
+
+static ssize_t ring_prev (list_t *lst, ssize_t idx) {
+
+    return (idx == 1) ? lst->cap : idx - 1;
+}
+
+void list_verify_level (list_t *lst, VER_LEVEL level) {
+
+    assert (lst);
+
+    lst->ver_level = level;
+}
+
+static VERIFICATION_CODE auto_verify (list_t *lst, ssize_t pos) {
+
+    if (lst->ver_level == VER_FULL) {
+
+        return list_verify (lst);
+    }
+
+    if (lst->ver_level == VER_OFF) {
+
+        return NO_FLAWS;
+    }
+
+    if (lst->cap < 0) {
+
+        printf ("\nVerification failed: list's *capacity* parameter ran below zero (%lld)\n", lst->cap);
+        return CAP_FLAW;
+    }
+
+    if (lst->free < 0 || lst->free > lst->cap) {
+
+        printf ("\nVerification failed: list's *free* index is out of range (%lld)\n", lst->free);
+        return FREE_FLAW;
+    }
+
+    if (lst->untouched < 1 || lst->untouched > lst->cap + 1) {
+
+        printf ("\nVerification failed: list's *untouched* position is out of range (%lld)\n", lst->untouched);
+        return UNTOUCHED_FLAW;
+    }
+
+    if (lst->free != FICT && !node_free (lst, lst->free)) {
+
+        printf ("\nVerification failed: the free node on position %lld has \
+                no *free node* marker (prev: %lld)\n",
+                lst->free, (ssize_t) node_prev (lst, lst->free));
+        return FREE_MARKER_FLAW;
+    }
+
+    VERIFICATION_CODE code = verify_node (lst, FICT);
+
+    if (code == NO_FLAWS && pos > FICT && pos <= lst->cap && !node_free (lst, pos)) {
+
+        code = verify_node (lst, pos);
+    }
+
+    for (ssize_t n_sample = 0; code == NO_FLAWS && lst->ver_level == VER_SAMPLED && n_sample < VER_SAMPLE_SIZE; ++ n_sample) {
+
+        ssize_t idx = ord_rand () % (lst->cap + 1);
+
+        if (!node_free (lst, idx)) {
+
+            code = verify_node (lst, idx);
+
+        } else if (idx < lst->untouched && (node_next (lst, idx) < 0 || node_next (lst, idx) > lst->cap)) {
+
+            printf ("\nVerification failed: the free node next to the one on position %lld has \
+                    an impossible index: %lld\n",
+                    idx, (ssize_t) node_next (lst, idx));
+            code = FREE_IDX_FLAW;
+        }
+    }
+
+    return code;
+}
+
+/*
+Checks the links of a single linked node: both of its
+neighbours have to exist and point back at it
+*/
+
+static VERIFICATION_CODE verify_node (list_t *lst, ssize_t idx) {
+
+    ssize_t next = node_next (lst, idx), prev = node_prev (lst, idx);
+
+    if (next < 0 || next > lst->cap || prev < 0 || prev > lst->cap) {
+
+        printf ("\nVerification failed: the node on position %lld has \
+                an impossible neighbour index (next: %lld, prev: %lld)\n",
+                idx, next, prev);
+        return LST_IDX_FLAW;
+    }
+
+    if (node_prev (lst, next) != idx || node_next (lst, prev) != idx) {
+
+        printf ("\nVerification failed: incongruity of next and prev parameters \
+                detected around the node on position %lld (next: %lld, prev: %lld)\n",
+                idx, next, prev);
+        return LST_SEQUENCE_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+DUMP_OPER_CODE list_dump (list_t *lst, const char *file_name, ssize_t pos /* = FICT */, ssize_t radius /* = -1 */) {
+
+    assert (lst);
+    assert (file_name);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DMP_VER_FAILED;
+    }
+
+#endif
+
+    dump_job_t *job = NULL;
+    DUMP_OPER_CODE code = dump_snapshot (lst, file_name, pos, radius, &job);
+
+    if (code != DUMPED) {
+
+        return code;
+    }
+
+    code = dump_render (job) ? DUMPED : COMMON_DMP_ERROR;
+    dump_free (job);
+
+    return code;
+}
+
+DUMP_OPER_CODE list_dump_async (list_t *lst, const char *file_name, ssize_t pos /* = FICT */, ssize_t radius /* = -1 */) {
+
+    assert (lst);
+    assert (file_name);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DMP_VER_FAILED;
+    }
+
+#endif
+
+    dump_job_t *job = NULL;
+    DUMP_OPER_CODE code = dump_snapshot (lst, file_name, pos, radius, &job);
+
+    if (code != DUMPED) {
+
+        return code;
+    }
+
+    dump_queue_t *queue = dump_queue ();
+    std::lock_guard<std::mutex> lock (queue->mutex);
+
+    if (!queue->started) {
+
+        std::thread (dump_worker, queue).detach ();
+        atexit (list_dump_wait);
+
+        queue->started = true;
+    }
+
+    queue->jobs.push_back (job);
+    queue->pending += 1;
+    queue->wake.notify_one ();
+
+    return DUMPED;
+}
+
+void list_dump_wait () {
+
+    dump_queue_t *queue = dump_queue ();
+    std::unique_lock<std::mutex> lock (queue->mutex);
+
+    queue->done.wait (lock, [queue] { return queue->pending == 0; });
+}
+
+SORT_OPER_CODE list_sort (list_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SRT_VER_FAILED;
+    }
+
+#endif
+
+    if (lst->reversed) {
+
+        unreverse (lst);
+    }
+
+    linearize (lst);
+    return SORTED;
+}
+
+/*
+The sort itself: the nodes are put on positions from 1
+to *size* in the order of their links (the direction
+of the list is left as it is). The free nodes after them
+aren't rewritten: they become never used ones, which makes
+the sort O(size) rather than O(cap)
+*/
+
+static void linearize (list_t *lst) {
+
+    ssize_t idx = node_next (lst, FICT), nseq = 1;
+    for ( ; idx != FICT; ++ nseq) {
+
+        node_swap (lst, idx, nseq);
+        idx = node_next (lst, nseq);
+    }
+
+    lst->free = (nseq <= lst->cap) ? nseq : (ssize_t) FICT;
+    lst->untouched = nseq;
+
+    if (lst->ord) {
+
+        ord_build (lst);
+    }
+
+    if (lst->hash) {
+
+        hash_build (lst);
+    }
+
+    if (lst->cmp.fprev) {
+
+        compact_end (lst);
+    }
+
+    lst->lin = lst->free ? lst->free - 1 : lst->cap;
+    lst->quick_mode = true;
+    lst->ring_head = FICT;
+}
+
+constexpr ssize_t MERGE_BINS = 64;                 // Enough for runs of up to 2^63 nodes
+constexpr ssize_t RADIX_BITS = 8;
+
+static auto elem_cmp = [] (elem_t a, elem_t b) {
+
+    return (a > b) - (a < b);
+};
+
+SORT_OPER_CODE list_sort_by (list_t *lst, int (*cmp) (elem_t a, elem_t b) /* = NULL */) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SRT_VER_FAILED;
+    }
+
+#endif
+
+    if (cmp) {
+
+        merge_sort (lst, cmp);
+
+    } else {
+
+        merge_sort (lst, elem_cmp);                                // Inlined, unlike a call through a pointer
+    }
+
+    return SORTED;
+}
+
+SORT_OPER_CODE list_sort_radix (list_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SRT_VER_FAILED;
+    }
+
+#endif
+
+    if (!radix_sort<elem_t> (lst)) {                            // Not an integer type or no memory for the keys
+
+        merge_sort (lst, elem_cmp);
+        linearize (lst);
+        return SORTED;
+    }
+
+    ssize_t size = lst->size, cap = lst->cap;
+
+    for (ssize_t idx = 1; idx <= size; ++ idx) {
+
+        node_next (lst, idx) = (idx < size) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+        node_prev (lst, idx) = idx - 1;
+    }
+
+    node_next (lst, FICT) = (size != 0) ? 1 : FICT;
+    node_prev (lst, FICT) = size;
+
+    lst->free = (size < cap) ? (ssize_t) (size + 1) : (ssize_t) FICT;
+    lst->untouched = size + 1;                          // As in linearize ()
+    lst->reversed = false;
+
+    if (lst->ord) {
+
+        ord_build (lst);
+    }
+
+    if (lst->hash) {
+
+        hash_build (lst);
+    }
+
+    if (lst->cmp.fprev) {
+
+        compact_end (lst);
+    }
+
+    lst->lin = size;
+    lst->quick_mode = true;
+    lst->ring_head = FICT;
+    return SORTED;
+}
+
+/*
+Bottom-up merge sort of the chain of *next* links (the
+same binary counter of runs std::list::sort () uses: *bins* [i]
+is either empty or a sorted run of 2^i nodes, every node is
+carried in like a bit added to a counter). Runs are terminated
+by FICT, and the fictional node itself is the merges' scratch
+head; *prev* links are rebuilt in one walk at the end.
+Nodes stay where they are, so positions stay valid
+*/
+
+template <typename C>
+static void merge_sort (list_t *lst, C cmp) {
+
+    if (lst->reversed) {
+
+        unreverse (lst);
+    }
+
+    ssize_t bins [MERGE_BINS] = {}, filled = 0;
+
+    for (ssize_t idx = node_next (lst, FICT); idx != FICT; ) {
+
+        ssize_t run = idx;
+        idx = node_next (lst, idx);
+        node_next (lst, run) = FICT;
+
+        ssize_t bin = 0;
+        for ( ; bin < filled && bins [bin] != FICT; ++ bin) {
+
+            run = merge_runs (lst, bins [bin], run, cmp);           // The run in the bin holds the earlier nodes
+            bins [bin] = FICT;
+        }
+
+        if (bin == filled) {
+
+            ++ filled;
+        }
+        bins [bin] = run;
+    }
+
+    ssize_t head = FICT;
+    for (ssize_t bin = 0; bin < filled; ++ bin) {
+
+        if (bins [bin] != FICT) {
+
+            head = (head == FICT) ? bins [bin] : merge_runs (lst, bins [bin], head, cmp);
+        }
+    }
+
+    /*
+    The linearized prefix is whatever part of the sorted
+    list happens to be in place; the quick mode survives only
+    if all of it is (then the free list hasn't changed either)
+    */
+
+    ssize_t prev = FICT, lin = 0;
+    for (ssize_t idx = head, nseq = 1; idx != FICT; idx = node_next (lst, idx), ++ nseq) {
+
+        node_prev (lst, idx) = prev;
+        prev = idx;
+
+        if (idx == nseq && lin == nseq - 1) {
+
+            lin = nseq;
+        }
+    }
+
+    node_next (lst, FICT) = head;
+    node_prev (lst, FICT) = prev;
+
+    lst->quick_mode = lst->quick_mode && lin == lst->size;
+    lst->ring_head = FICT;
+    lst->lin = lin;
+
+    if (lst->ord) {
+
+        ord_build (lst);
+    }
+
+    compact_tick (lst, FICT);
+}
+
+/*
+Merges two FICT-terminated runs (nodes of *a* go first
+among equal ones) and returns the head of the result
+*/
+
+template <typename C>
+static ssize_t merge_runs (list_t *lst, ssize_t a, ssize_t b, C cmp) {
+
+    ssize_t tail = FICT;
+
+    while (a != FICT && b != FICT) {
+
+        if (cmp (node_elem (lst, a), node_elem (lst, b)) <= 0) {
+
+            node_next (lst, tail) = a;
+            tail = a;
+            a = node_next (lst, a);
+
+        } else {
+
+            node_next (lst, tail) = b;
+            tail = b;
+            b = node_next (lst, b);
+        }
+    }
+
+    node_next (lst, tail) = (a != FICT) ? a : b;
+
+    return node_next (lst, FICT);
+}
+
+/*
+LSD radix sort of the elements (taken in the logical order)
+by RADIX_BITS-bit digits, the sign bit flipped so that negative
+ones go first. The histograms of all the digits are made in the
+same pass that copies the elements out, and digits that are
+the same in all the elements are skipped. The elements ping-pong
+between two halves of a buffer, and the last pass scatters them
+right to positions from 1 to *size* - the links are left for the
+caller. Returns false (with the list untouched) if *T* is not
+an integer type or there's no memory for the buffer
+*/
+
+template <typename T>
+static bool radix_sort (list_t *lst) {
+
+    if constexpr (!std::is_integral<T>::value) {
+
+        (void) lst;
+        return false;
+
+    } else {
+
+        typedef typename std::make_unsigned<T>::type key_t;
+
+        constexpr ssize_t DIGITS = sizeof (T) * CHAR_BIT / RADIX_BITS;
+        constexpr ssize_t BUCKETS = (ssize_t) 1 << RADIX_BITS;
+        constexpr key_t SIGN = std::is_signed<T>::value ? (key_t) ((key_t) 1 << (sizeof (T) * CHAR_BIT - 1)) : 0;
+
+        ssize_t size = lst->size;
+
+        T *buf = (T *) malloc ((2 * size + 1) * sizeof (T));
+        ssize_t (*count) [BUCKETS] = (ssize_t (*) [BUCKETS]) calloc (DIGITS, sizeof (*count));
+
+        if (buf == NULL || count == NULL) {
+
+            free (buf);
+            free (count);
+            return false;
+        }
+
+        ssize_t idx = lst->reversed ? node_prev (lst, FICT) : node_next (lst, FICT);
+        for (ssize_t i = 0; i < size; ++ i) {
+
+            buf [i] = node_elem (lst, idx);
+            idx = lst->reversed ? node_prev (lst, idx) : node_next (lst, idx);
+
+            key_t key = (key_t) buf [i] ^ SIGN;
+            for (ssize_t dig = 0; dig < DIGITS; ++ dig) {
+
+                ++ count [dig] [(key >> (dig * RADIX_BITS)) & (BUCKETS - 1)];
+            }
+        }
+
+        ssize_t last = -1;
+        for (ssize_t dig = 0; dig < DIGITS; ++ dig) {
+
+            if (size != 0 && count [dig] [(((key_t) buf [0] ^ SIGN) >> (dig * RADIX_BITS)) & (BUCKETS - 1)] != size) {
+
+                last = dig;
+            }
+        }
+
+        T *src = buf, *dst = buf + size;
+        for (ssize_t dig = 0; dig <= last; ++ dig) {
+
+            ssize_t *offs = count [dig];
+            if (offs [(((key_t) src [0] ^ SIGN) >> (dig * RADIX_BITS)) & (BUCKETS - 1)] == size) {
+
+                continue;
+            }
+
+            for (ssize_t bucket = 0, sum = 0; bucket < BUCKETS; ++ bucket) {
+
+                ssize_t n = offs [bucket];
+                offs [bucket] = sum;
+                sum += n;
+            }
+
+            for (ssize_t i = 0; i < size; ++ i) {
+
+                ssize_t at = offs [(((key_t) src [i] ^ SIGN) >> (dig * RADIX_BITS)) & (BUCKETS - 1)] ++;
+
+                if (dig == last) {
+
+                    node_elem (lst, at + 1) = src [i];
+
+                } else {
+
+                    dst [at] = src [i];
+                }
+            }
+
+            T *temp = src;
+            src = dst;
+            dst = temp;
+        }
+
+        if (last == -1) {                                       // All the elements are equal (or there are none)
+
+            for (ssize_t i = 0; i < size; ++ i) {
+
+                node_elem (lst, i + 1) = src [i];
+            }
+        }
+
+        free (buf);
+        free (count);
+        return true;
+    }
+}
+
+static void node_swap (list_t *lst, ssize_t idx1, ssize_t idx2) {
+
+    assert (lst);
+    assert (idx1 > 0);
+    assert (idx2 > 0);
+    assert (idx1 <= lst->cap);
+    assert (idx2 <= lst->cap);
+
+    if (idx1 == idx2) {
+
+        return;
+    }
+
+    node_t temp_nd = node_load (lst, idx1);
+    node_store (lst, idx1, node_load (lst, idx2));
+    node_store (lst, idx2, temp_nd);
+
+    ssize_t swapped [2] = {idx1, idx2};         // Links are fixed after the swap so that adjacent nodes are handled as well; free nodes are skipped, because sorting func rebuilds the free list itself
+    for (int i = 0; i < 2; ++ i) {
+
+        ssize_t idx = swapped [i];
+        if (node_prev (lst, idx) == FREE_NODE_MARKER) {
+
+            continue;
+        }
+
+        if (node_next (lst, idx) == idx1 || node_next (lst, idx) == idx2) {
+
+            node_next (lst, idx) = idx1 + idx2 - node_next (lst, idx);
+        }
+
+        if (node_prev (lst, idx) == idx1 || node_prev (lst, idx) == idx2) {
+
+            node_prev (lst, idx) = idx1 + idx2 - node_prev (lst, idx);
+        }
+    }
+
+    for (int i = 0; i < 2; ++ i) {
+
+        if (node_prev (lst, swapped [i]) == FREE_NODE_MARKER) {
+
+            continue;
+        }
+
+        node_next (lst, node_prev (lst, swapped [i])) = swapped [i];
+        node_prev (lst, node_next (lst, swapped [i])) = swapped [i];
+    }
+}
+
+RESIZE_OPER_CODE list_resize_up (list_t *lst) {
+
+    return resize_to (lst, grown_cap (lst));
+}
+
+/*
+Grows the list up to capacity *new_cap* (or a bit more, if
+the storage rounds it up) and links the new nodes into
+the free list as an ascending run. If the run can go to the
+free list's tail (the free list is empty, ends with never used
+nodes or is ascending in the quick mode, so that the mode is kept)
+the new nodes are just never used ones and aren't written.
+Otherwise, and while compaction is on, they are written
+out at the free list's head in O(new_cap - cap)
+*/
+
+static RESIZE_OPER_CODE resize_to (list_t *lst, ssize_t new_cap) {
+
+    new_cap = storage_cap (new_cap < MAX_CAP ? new_cap : MAX_CAP);
+    if (new_cap <= lst->cap) {
+
+        return RSZ_MEM_ERROR;
+    }
+
+    if (lst->ring_head != FICT) {
+
+        lst->ring_head = FICT;          // The ring can't be stretched over the new positions
+    }
+
+    if (!side_arrays_realloc (lst, new_cap)) {
+
+        return RSZ_MEM_ERROR;
+    }
+
+    ssize_t old_cap = lst->cap;
+
+    new_cap = storage_grow (lst, new_cap);
+    if (new_cap == OPER_ERROR_MEM) {
+
+        return RSZ_MEM_ERROR;
+    }
+
+    lst->cap = new_cap;
+
+    if (lst->cmp.fprev == NULL) {                   // Compaction keeps all the free nodes written (see compact_begin ())
+
+        if (lst->free == FICT) {
+
+            assert (lst->untouched == old_cap + 1);
+            lst->free = old_cap + 1;
+            return RESIZED;
+        }
+
+        if (lst->untouched <= old_cap) {            // The never used nodes are the free list's tail
+
+            return RESIZED;
+        }
+
+        if (lst->quick_mode) {
+
+            node_next (lst, old_cap) = old_cap + 1;
+            return RESIZED;
+        }
+    }
+
+    lst->untouched = lst->cap + 1;
+
+    ssize_t idx = old_cap + 1;
+    for ( ; idx < lst->cap; ++ idx) {
+
+        node_elem (lst, idx) = FREE_NODE_ELEM;
+        node_prev (lst, idx) = FREE_NODE_MARKER;
+        node_next (lst, idx) = idx + 1;
+    }
+    node_elem (lst, idx) = FREE_NODE_ELEM;
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = lst->free;
+
+    if (lst->free == FICT) {
+
+        lst->free = old_cap + 1;
+
+        if (lst->cmp.fprev) {                       // The free list was empty, so the new nodes make up an ascending run by themselves
+
+            lst->cmp.tail = lst->cap;
+            lst->cmp.lo = old_cap + 1;
+            lst->cmp.hi = lst->cap;
+        }
+
+    } else if (lst->quick_mode) {
+
+        node_next (lst, lst->cap) = FICT;
+        node_next (lst, old_cap) = old_cap + 1;     // In the quick mode the free list is ascending, so its tail is the last node
+
+    } else {
+
+        if (lst->cmp.fprev) {
+
+            lst->cmp.fprev [lst->free] = lst->cap;
+        }
+
+        lst->free = old_cap + 1;
+    }
+
+    if (lst->cmp.fprev) {
+
+        lst->cmp.fprev [old_cap + 1] = FICT;
+        for (idx = old_cap + 2; idx <= lst->cap; ++ idx) {
+
+            lst->cmp.fprev [idx] = idx - 1;
+        }
+    }
+
+    return RESIZED;
+}
+
+static bool side_arrays_realloc (list_t *lst, ssize_t new_cap) {
+
+    if (lst->ord) {
+
+        ssize_t kept = (lst->cap < new_cap) ? lst->cap : new_cap;
+
+        ord_node_t *ord_buffer = (ord_node_t *) buffer_realloc (lst, lst->ord, (kept + 1) * sizeof (ord_node_t),
+                                                                (new_cap + 1) * sizeof (ord_node_t));
+        if (ord_buffer == NULL) {
+
+            return false;
+        }
+
+        lst->ord = ord_buffer;
+    }
+
+    if (lst->cmp.fprev) {
+
+        idx_t *fprev_buffer = (idx_t *) realloc (lst->cmp.fprev, (new_cap + 1) * sizeof (idx_t));
+        if (fprev_buffer == NULL) {
+
+            return false;
+        }
+
+        lst->cmp.fprev = fprev_buffer;
+    }
+
+    if (lst->hash && hash_slots (new_cap) != lst->hash_cap) {
+
+        idx_t *old_hash = lst->hash;
+        ssize_t old_hash_cap = lst->hash_cap;
+
+        lst->hash = (idx_t *) calloc (hash_slots (new_cap), sizeof (idx_t));
+        if (lst->hash == NULL) {
+
+            lst->hash = old_hash;
+            return false;
+        }
+
+        lst->hash_cap = hash_slots (new_cap);
+        for (ssize_t slot = 0; slot < old_hash_cap; ++ slot) {
+
+            if (old_hash [slot] != FICT) {
+
+                hash_insert (lst, old_hash [slot]);
+            }
+        }
+
+        free (old_hash);
+    }
+
+    return true;
+}
+
+RESERVE_OPER_CODE list_reserve (list_t *lst, ssize_t cap) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return RSV_VER_FAILED;
+    }
+
+#endif
+
+    if (cap <= lst->cap) {
+
+        return RESERVED;
+    }
+
+    if (resize_to (lst, cap) == RSZ_MEM_ERROR) {
+
+        printf ("\nReserve failed: memory error while trying to resize up \
+                from capacity %lld to capacity %lld, in function list_reserve ()\n",
+                lst->cap, cap);
+        return RSV_MEM_ERROR;
+    }
+
+    return RESERVED;
+}
+
+SHRINK_OPER_CODE list_shrink_to_fit (list_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SHR_VER_FAILED;
+    }
+
+#endif
+
+    return shrink (lst);
+}
+
+void list_shrink_auto (list_t *lst, ssize_t ratio) {
+
+    assert (lst);
+    assert (ratio == 0 || ratio > 1);
+
+    lst->shrink_ratio = ratio;
+}
+
+void list_growth (list_t *lst, double factor, ssize_t step, ssize_t max_step) {
+
+    assert (lst);
+    assert (factor >= 1 && step >= 0 && max_step >= 0);
+
+    lst->growth = {factor, step, max_step};
+}
+
+/*
+Linearizes the list with the sorting func, so that all the
+free nodes are at the end of the array, then cuts them off
+*/
+
+static SHRINK_OPER_CODE shrink (list_t *lst) {
+
+    if (!lst->quick_mode) {
+
+        linearize (lst);
+    }
+
+    ssize_t new_cap = storage_shrink (lst, lst->size);
+    if (new_cap == OPER_ERROR_MEM) {
+
+        printf ("\nShrink failed: memory error while trying to resize down \
+                from capacity %lld to capacity %lld, in function list_shrink_to_fit ()\n",
+                lst->cap, lst->size);
+        return SHR_MEM_ERROR;
+    }
+
+    lst->cap = new_cap;
+    side_arrays_realloc (lst, new_cap);             // Shrinking reallocations can't move the data, so a failure just leaves the side arrays bigger than needed
+
+    lst->free = (lst->size < lst->cap) ? (ssize_t) (lst->size + 1) : (ssize_t) FICT;
+    lst->untouched = lst->size + 1;                 // The free nodes left (if the storage rounds the capacity up) are taken for never used ones
+
+    return SHRUNK;
+}
+
+static void shrink_tick (list_t *lst) {
+
+    if (lst->shrink_ratio != 0 && lst->size * lst->shrink_ratio < lst->cap) {
+
+        shrink (lst);
+    }
+}
+
+ORD_OPER_CODE list_ord_on (list_t *lst) {
+
+    assert (lst);
+
+    if (lst->ord == NULL) {
+
+        lst->ord = (ord_node_t *) calloc (lst->cap + 1, sizeof (ord_node_t));
+        if (lst->ord == NULL) {
+
+            printf ("\nOrder index construction failed: memory error\n");
+            return ORD_MEM_ERROR;
+        }
+    }
+
+    ord_build (lst);
+
+    return ORD_ON;
+}
+
+void list_ord_off (list_t *lst) {
+
+    assert (lst);
+
+    buffer_free (lst, lst->ord);
+    lst->ord = NULL;
+    lst->ord_root = FICT;
+}
+
+static unsigned ord_rand () {
+
+    static thread_local unsigned state = 2463534242u;       // Per thread: threads working on different lists don't share it
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+static void ord_update (list_t *lst, ssize_t idx) {
+
+    lst->ord [idx].size = lst->ord [lst->ord [idx].left].size + lst->ord [lst->ord [idx].right].size + 1;
+}
+
+static ssize_t ord_merge (list_t *lst, ssize_t left, ssize_t right) {
+
+    if (left == FICT) {
+
+        return right;
+    }
+
+    if (right == FICT) {
+
+        return left;
+    }
+
+    ord_node_t *ord = lst->ord;
+
+    if (ord [left].prio > ord [right].prio) {
+
+        ord [left].right = ord_merge (lst, ord [left].right, right);
+        ord [ord [left].right].parent = left;
+        ord_update (lst, left);
+
+        return left;
+    }
+
+    ord [right].left = ord_merge (lst, left, ord [right].left);
+    ord [ord [right].left].parent = right;
+    ord_update (lst, right);
+
+    return right;
+}
+
+/*
+Splits the subtree *root* so that its first *nseq*
+nodes (in the order of the list) go to *left*
+and all the others go to *right*
+*/
+
+static void ord_split (list_t *lst, ssize_t root, ssize_t nseq, idx_t *left, idx_t *right) {
+
+    if (root == FICT) {
+
+        *left = FICT;
+        *right = FICT;
+        return;
+    }
+
+    ord_node_t *ord = lst->ord;
+
+    if (ord [ord [root].left].size < nseq) {
+
+        ord_split (lst, ord [root].right, nseq - ord [ord [root].left].size - 1, &ord [root].right, right);
+        if (ord [root].right != FICT) {
+
+            ord [ord [root].right].parent = root;
+        }
+
+        *left = root;
+
+    } else {
+
+        ord_split (lst, ord [root].left, nseq, left, &ord [root].left);
+        if (ord [root].left != FICT) {
+
+            ord [ord [root].left].parent = root;
+        }
+
+        *right = root;
+    }
+
+    ord_update (lst, root);
+}
+
+static ssize_t ord_rank (list_t *lst, ssize_t idx) {
+
+    ord_node_t *ord = lst->ord;
+
+    ssize_t nseq = ord [ord [idx].left].size + 1;
+    for ( ; idx != lst->ord_root; idx = ord [idx].parent) {
+
+        if (ord [ord [idx].parent].right == idx) {
+
+            nseq += ord [ord [ord [idx].parent].left].size + 1;
+        }
+    }
+
+    return nseq;
+}
+
+static ssize_t ord_select (list_t *lst, ssize_t nseq) {
+
+    ord_node_t *ord = lst->ord;
+
+    if (nseq == FICT) {
+
+        return FICT;
+    }
+
+    ssize_t idx = lst->ord_root;
+    while (nseq != ord [ord [idx].left].size + 1) {
+
+        if (nseq <= ord [ord [idx].left].size) {
+
+            idx = ord [idx].left;
+
+        } else {
+
+            nseq -= ord [ord [idx].left].size + 1;
+            idx = ord [idx].right;
+        }
+    }
+
+    return idx;
+}
+
+void ord_link (list_t *lst, ssize_t idx) {
+
+    ord_node_t *ord = lst->ord;
+
+    ssize_t nseq = (node_prev (lst, idx) == FICT) ? 0 : ord_rank (lst, node_prev (lst, idx));
+
+    ord [idx].left = FICT;
+    ord [idx].right = FICT;
+    ord [idx].parent = FICT;
+    ord [idx].size = 1;
+    ord [idx].prio = ord_rand ();
+
+    idx_t left = FICT, right = FICT;
+    ord_split (lst, lst->ord_root, nseq, &left, &right);
+
+    lst->ord_root = ord_merge (lst, ord_merge (lst, left, idx), right);
+    ord [lst->ord_root].parent = FICT;
+}
+
+void ord_unlink (list_t *lst, ssize_t idx) {
+
+    ord_node_t *ord = lst->ord;
+
+    ssize_t child = ord_merge (lst, ord [idx].left, ord [idx].right);
+    ssize_t parent = ord [idx].parent;
+
+    if (child != FICT) {
+
+        ord [child].parent = parent;
+    }
+
+    if (idx == lst->ord_root) {
+
+        lst->ord_root = child;
+        return;
+    }
+
+    if (ord [parent].left == idx) {
+
+        ord [parent].left = child;
+
+    } else {
+
+        ord [parent].right = child;
+    }
+
+    for ( ; parent != FICT; parent = ord [parent].parent) {
+
+        ord [parent].size -= 1;
+    }
+}
+
+/*
+Builds the treap in O(n) with a single pass in the order of the
+list: the right spine of the tree is kept as a stack threaded
+through *parent* links, and a node's size is finalized as soon
+as it is popped from the spine (it can't get new descendants then)
+*/
+
+static void ord_build (list_t *lst) {
+
+    ord_node_t *ord = lst->ord;
+
+    ord [FICT].left = FICT;
+    ord [FICT].right = FICT;
+    ord [FICT].parent = FICT;
+    ord [FICT].size = 0;
+
+    ssize_t last = FICT;
+    for (ssize_t idx = node_next (lst, FICT); idx != FICT; idx = node_next (lst, idx)) {
+
+        ord [idx].left = FICT;
+        ord [idx].right = FICT;
+        ord [idx].prio = ord_rand ();
+
+        ssize_t spine = last, popped = FICT;
+        while (spine != FICT && ord [spine].prio < ord [idx].prio) {
+
+            ord_update (lst, spine);
+            popped = spine;
+            spine = ord [spine].parent;
+        }
+
+        ord [idx].left = popped;
+        if (popped != FICT) {
+
+            ord [popped].parent = idx;
+        }
+
+        ord [idx].parent = spine;
+        if (spine != FICT) {
+
+            ord [spine].right = idx;
+        }
+
+        last = idx;
+    }
+
+    lst->ord_root = FICT;
+    for ( ; last != FICT; last = ord [last].parent) {
+
+        ord_update (lst, last);
+        lst->ord_root = last;
+    }
+}
+
+static void ord_swap (list_t *lst, ssize_t idx1, ssize_t idx2) {
+
+    ord_node_t *ord = lst->ord;
+
+    ssize_t swapped [2] = {idx1, idx2};
+    bool is_left [2] = {};
+    for (int i = 0; i < 2; ++ i) {
+
+        is_left [i] = ord [ord [swapped [i]].parent].left == swapped [i];
+    }
+
+    ord_node_t temp_nd = ord [idx1];
+    ord [idx1] = ord [idx2];
+    ord [idx2] = temp_nd;
+
+    for (int i = 0; i < 2; ++ i) {
+
+        idx_t *links [3] = {&ord [swapped [i]].left, &ord [swapped [i]].right, &ord [swapped [i]].parent};
+        for (int j = 0; j < 3; ++ j) {
+
+            if (*links [j] == idx1 || *links [j] == idx2) {
+
+                *links [j] = idx1 + idx2 - *links [j];
+            }
+        }
+    }
+
+    for (int i = 0; i < 2; ++ i) {
+
+        ssize_t idx = swapped [i];
+
+        if (ord [idx].parent == FICT) {
+
+            lst->ord_root = idx;
+
+        } else if (is_left [1 - i]) {
+
+            ord [ord [idx].parent].left = idx;
+
+        } else {
+
+            ord [ord [idx].parent].right = idx;
+        }
+
+        if (ord [idx].left != FICT) {
+
+            ord [ord [idx].left].parent = idx;
+        }
+
+        if (ord [idx].right != FICT) {
+
+            ord [ord [idx].right].parent = idx;
+        }
+    }
+}
+
+static void ord_move (list_t *lst, ssize_t from, ssize_t to) {
+
+    ord_node_t *ord = lst->ord;
+
+    ord [to] = ord [from];
+
+    if (ord [to].parent == FICT) {
+
+        lst->ord_root = to;
+
+    } else if (ord [ord [to].parent].left == from) {
+
+        ord [ord [to].parent].left = to;
+
+    } else {
+
+        ord [ord [to].parent].right = to;
+    }
+
+    if (ord [to].left != FICT) {
+
+        ord [ord [to].left].parent = to;
+    }
+
+    if (ord [to].right != FICT) {
+
+        ord [ord [to].right].parent = to;
+    }
+}
+
+constexpr uint64_t HASH_MUL = 0x9E3779B97F4A7C15ull;          // 2^64 / golden ratio
+
+HASH_OPER_CODE list_hash_on (list_t *lst) {
+
+    assert (lst);
+
+    if (lst->hash == NULL) {
+
+        lst->hash = (idx_t *) calloc (hash_slots (lst->cap), sizeof (idx_t));
+        if (lst->hash == NULL) {
+
+            printf ("\nValue index construction failed: memory error\n");
+            return HASH_MEM_ERROR;
+        }
+
+        lst->hash_cap = hash_slots (lst->cap);
+    }
+
+    hash_build (lst);
+
+    return HASH_ON;
+}
+
+void list_hash_off (list_t *lst) {
+
+    assert (lst);
+
+    free (lst->hash);
+    lst->hash = NULL;
+    lst->hash_cap = 0;
+}
+
+ssize_t list_find (list_t *lst, elem_t val) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    return find (lst, val);
+}
+
+bool list_contains (list_t *lst, elem_t val) {
+
+    return list_find (lst, val) > FICT;
+}
+
+DEL_VAL_OPER_CODE list_delete_value (list_t *lst, elem_t val) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_VAL_VER_FAILED;
+    }
+
+#endif
+
+    ssize_t pos = find (lst, val);
+    if (pos == FICT) {
+
+        return NO_VAL_TO_DELETE;
+    }
+
+    if (pos != node_prev (lst, FICT)) {
+
+        lst->quick_mode = false;
+    }
+
+    del (lst, pos);
+
+    compact_tick (lst, FICT);
+    shrink_tick (lst);
+    return VAL_DELETED;
+}
+
+/*
+At least twice as many slots as there are nodes
+(the fictional one included), so that the table is
+never more than half full and probe runs stay short
+*/
+
+static ssize_t hash_slots (ssize_t cap) {
+
+    ssize_t slots = 2;
+    while (slots < 2 * (cap + 1)) {
+
+        slots *= 2;
+    }
+
+    return slots;
+}
+
+/*
+Fibonacci hashing: the high bits of the product
+*/
+
+static ssize_t hash_home (list_t *lst, elem_t val) {
+
+    return (ssize_t) (((uint64_t) (int64_t) val * HASH_MUL) >> (64 - __builtin_ctzll ((uint64_t) lst->hash_cap)));
+}
+
+static void hash_insert (list_t *lst, ssize_t idx) {
+
+    ssize_t mask = lst->hash_cap - 1;
+
+    ssize_t slot = hash_home (lst, node_elem (lst, idx));
+    while (lst->hash [slot] != FICT) {
+
+        slot = (slot + 1) & mask;
+    }
+
+    lst->hash [slot] = idx;
+}
+
+/*
+The slot holding position *idx* (which must be in
+the table), *val* being the element it was hashed by
+*/
+
+static ssize_t hash_slot (list_t *lst, ssize_t idx, elem_t val) {
+
+    ssize_t mask = lst->hash_cap - 1;
+
+    ssize_t slot = hash_home (lst, val);
+    while (lst->hash [slot] != idx) {
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void hash_link (list_t *lst, ssize_t idx) {
+
+    hash_insert (lst, idx);
+}
+
+/*
+Backward shift deletion: the entries after the hole that
+may move closer to their home slots are moved into it,
+so no tombstones are left and lookups of absent values
+still stop at the first empty slot
+*/
+
+void hash_unlink (list_t *lst, ssize_t idx) {
+
+    idx_t *hash = lst->hash;
+    ssize_t mask = lst->hash_cap - 1;
+
+    ssize_t hole = hash_slot (lst, idx, node_elem (lst, idx));
+    for (ssize_t slot = (hole + 1) & mask; hash [slot] != FICT; slot = (slot + 1) & mask) {
+
+        ssize_t home = hash_home (lst, node_elem (lst, hash [slot]));
+
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+
+            hash [hole] = hash [slot];
+            hole = slot;
+        }
+    }
+
+    hash [hole] = FICT;
+}
+
+static void hash_build (list_t *lst) {
+
+    for (ssize_t slot = 0; slot < lst->hash_cap; ++ slot) {
+
+        lst->hash [slot] = FICT;
+    }
+
+    for (ssize_t idx = node_next (lst, FICT); idx != FICT; idx = node_next (lst, idx)) {
+
+        hash_insert (lst, idx);
+    }
+}
+
+/*
+Called after two live nodes have been swapped: each of
+them is now hashed by the element of the other one
+*/
+
+static void hash_swap (list_t *lst, ssize_t idx1, ssize_t idx2) {
+
+    ssize_t slot1 = hash_slot (lst, idx1, node_elem (lst, idx2));
+    ssize_t slot2 = hash_slot (lst, idx2, node_elem (lst, idx1));
+
+    lst->hash [slot1] = idx2;
+    lst->hash [slot2] = idx1;
+}
+
+/*
+Called after a live node has been moved from *from* to *to*
+*/
+
+static void hash_move (list_t *lst, ssize_t from, ssize_t to) {
+
+    lst->hash [hash_slot (lst, from, node_elem (lst, to))] = to;
+}
+
+/*
+Every entry must be a live node reachable from its home
+slot without crossing an empty one, and there must be
+as many entries as there are nodes in the list
+*/
+
+static VERIFICATION_CODE verify_hash (list_t *lst) {
+
+    ssize_t mask = lst->hash_cap - 1, entries = 0;
+
+    for (ssize_t slot = 0; slot < lst->hash_cap; ++ slot) {
+
+        ssize_t idx = lst->hash [slot];
+        if (idx == FICT) {
+
+            continue;
+        }
+
+        if (idx < 0 || idx > lst->cap || node_free (lst, idx)) {
+
+            printf ("\nVerification failed: value index slot %lld holds \
+                    position %lld, which is not a live node\n", slot, idx);
+            return HASH_FLAW;
+        }
+
+        for (ssize_t probe = hash_home (lst, node_elem (lst, idx)); probe != slot; probe = (probe + 1) & mask) {
+
+            if (lst->hash [probe] == FICT) {
+
+                printf ("\nVerification failed: the node on position %lld can't be found \
+                        in the value index (its slot %lld is past an empty one)\n", idx, slot);
+                return HASH_FLAW;
+            }
+        }
+
+        entries += 1;
+    }
+
+    if (entries != lst->size) {
+
+        printf ("\nVerification failed: number of value index entries doesn't match \
+                list's size (%lld against %lld)\n", entries, lst->size);
+        return HASH_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+/*
+Without the index: the positions taken by the list in the quick
+and the ring modes are scanned as an array (the linearized prefix
+as well, the rest of the list is walked)
+*/
+
+static ssize_t find (list_t *lst, elem_t val) {
+
+    if (lst->hash) {
+
+        ssize_t mask = lst->hash_cap - 1;
+
+        for (ssize_t slot = hash_home (lst, val); lst->hash [slot] != FICT; slot = (slot + 1) & mask) {
+
+            if (node_elem (lst, lst->hash [slot]) == val) {
+
+                return lst->hash [slot];
+            }
+        }
+
+        return FICT;
+    }
+
+    if (lst->quick_mode) {
+
+        return scan_range (lst, 1, lst->size + 1, val);
+    }
+
+    if (lst->ring_head != FICT) {
+
+        ssize_t end = lst->ring_head + lst->size;
+        if (end <= lst->cap + 1) {
+
+            return scan_range (lst, lst->ring_head, end, val);
+        }
+
+        ssize_t found = scan_range (lst, lst->ring_head, lst->cap + 1, val);
+        return (found != FICT) ? found : scan_range (lst, 1, end - lst->cap, val);
+    }
+
+    ssize_t found = scan_range (lst, 1, lst->lin + 1, val);
+    if (found != FICT) {
+
+        return found;
+    }
+
+    for (ssize_t idx = node_next (lst, lst->lin); idx != FICT; idx = node_next (lst, idx)) {
+
+        if (node_elem (lst, idx) == val) {
+
+            return idx;
+        }
+    }
+
+    return FICT;
+}
+
+/*
+Positions from *from* to *to* - 1, all of them live
+*/
+
+static ssize_t scan_range (list_t *lst, ssize_t from, ssize_t to, elem_t val) {
+
+#ifdef LIST_SOA_STORAGE
+
+    while (from < to) {
+
+#ifdef LIST_SEGMENTED_STORAGE
+        ssize_t end = ((from | CHUNK_MASK) + 1 < to) ? (from | CHUNK_MASK) + 1 : to;      // Elements are contiguous inside a chunk
+#else
+        ssize_t end = to;
+#endif
+
+        ssize_t found = elem_scan (&node_elem (lst, from), end - from, val);
+        if (found != -1) {
+
+            return from + found;
+        }
+
+        from = end;
+    }
+
+#else
+
+    for ( ; from < to; ++ from) {
+
+        if (node_elem (lst, from) == val) {
+
+            return from;
+        }
+    }
+
+#endif
+
+    return FICT;
+}
+
+#ifdef LIST_SOA_STORAGE
+
+/*
+Index of *val* in *elems* (-1 if it's not there): with
+SSE2 and 32-bit elements 16 of them are compared at once
+*/
+
+static ssize_t elem_scan (const elem_t *elems, ssize_t n, elem_t val) {
+
+    ssize_t i = 0;
+
+#ifdef __SSE2__
+
+    if constexpr (sizeof (elem_t) == 4 && std::is_integral<elem_t>::value) {
+
+        __m128i key = _mm_set1_epi32 ((int) val);
+
+        for ( ; i + 16 <= n; i += 16) {
+
+            const __m128i *block = (const __m128i *) (elems + i);
+
+            int masks [4] = {};
+            for (int part = 0; part < 4; ++ part) {
+
+                masks [part] = _mm_movemask_ps (_mm_castsi128_ps (_mm_cmpeq_epi32 (_mm_loadu_si128 (block + part), key)));
+            }
+
+            if ((masks [0] | masks [1] | masks [2] | masks [3]) != 0) {
+
+                for (int part = 0; part < 4; ++ part) {
+
+                    if (masks [part] != 0) {
+
+                        return i + part * 4 + __builtin_ctz ((unsigned) masks [part]);
+                    }
+                }
+            }
+        }
+    }
+
+#endif
+
+    for ( ; i < n; ++ i) {
+
+        if (elems [i] == val) {
+
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+#endif
+
+COMPACT_OPER_CODE list_compact_step (list_t *lst, ssize_t budget) {
+
+    assert (lst);
+    assert (budget >= 0);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (auto_verify (lst, FICT) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return CMP_VER_FAILED;
+    }
+
+#endif
+
+    if (lst->quick_mode) {
+
+        return COMPACTED;
+    }
+
+    if (lst->cmp.fprev == NULL && compact_begin (lst) == CMP_MEM_ERROR) {
+
+        return CMP_MEM_ERROR;
+    }
+
+    compact_step (lst, budget, FICT);
+
+    return lst->quick_mode ? COMPACTED : COMPACTING;
+}
+
+void list_compact_auto (list_t *lst, ssize_t budget) {
+
+    assert (lst);
+    assert (budget >= 0);
+
+    lst->cmp.budget = budget;
+}
+
+static COMPACT_OPER_CODE compact_begin (list_t *lst) {
+
+    lst->ring_head = FICT;
+    free_settle (lst);                              // Compaction moves free nodes around by positions
+
+    lst->cmp.fprev = (idx_t *) malloc ((lst->cap + 1) * sizeof (idx_t));
+    if (lst->cmp.fprev == NULL) {
+
+        printf ("\nCompaction failed: memory error while trying to allocate \
+                free list back links for capacity %lld\n", lst->cap);
+        return CMP_MEM_ERROR;
+    }
+
+    lst->cmp.walk = FICT;
+    lst->cmp.walked = false;
+    lst->cmp.tail = FICT;
+    lst->cmp.lo = 1;
+    lst->cmp.hi = 0;
+
+    return COMPACTING;
+}
+
+static void compact_end (list_t *lst) {
+
+    free (lst->cmp.fprev);
+    lst->cmp.fprev = NULL;
+}
+
+/*
+Makes up to *budget* compaction steps and returns
+the new position of the node that was on position *track*.
+A step either places one more node into the linearized
+prefix, or visits one node of the free list while
+collecting back links, or moves one free node into
+the ascending run at the free list's tail
+*/
+
+static ssize_t compact_step (list_t *lst, ssize_t budget, ssize_t track) {
+
+    for ( ; budget > 0; -- budget) {
+
+        ssize_t nseq = lst->lin + 1;
+        ssize_t idx = node_next (lst, lst->lin);
+
+        if (idx == nseq) {
+
+            lst->lin = nseq;
+            continue;
+        }
+
+        if (idx != FICT && node_prev (lst, nseq) != FREE_NODE_MARKER) {
+
+            node_swap (lst, idx, nseq);
+            if (lst->ord) {
+
+                ord_swap (lst, idx, nseq);
+            }
+
+            if (lst->hash) {
+
+                hash_swap (lst, idx, nseq);
+            }
+
+            track = (track == idx) ? nseq : (track == nseq) ? idx : track;
+            lst->lin = nseq;
+            continue;
+        }
+
+        if (!lst->cmp.walked) {
+
+            compact_walk (lst);
+            continue;
+        }
+
+        if (idx != FICT) {
+
+            compact_move (lst, idx, nseq);
+
+            track = (track == idx) ? nseq : track;
+            lst->lin = nseq;
+            continue;
+        }
+
+        if (compact_thread (lst)) {
+
+            compact_end (lst);
+            lst->quick_mode = true;
+            break;
+        }
+    }
+
+    return track;
+}
+
+static ssize_t compact_tick (list_t *lst, ssize_t track) {
+
+    if (lst->cmp.budget == 0 || lst->quick_mode) {
+
+        return track;
+    }
+
+    if (lst->cmp.fprev == NULL && compact_begin (lst) == CMP_MEM_ERROR) {
+
+        return track;
+    }
+
+    return compact_step (lst, lst->cmp.budget, track);
+}
+
+static void compact_walk (list_t *lst) {
+
+    ssize_t idx = (lst->cmp.walk == FICT) ? lst->free : node_next (lst, lst->cmp.walk);
+
+    if (idx == FICT) {
+
+        lst->cmp.walked = true;
+        lst->cmp.tail = lst->cmp.walk;
+        return;
+    }
+
+    lst->cmp.fprev [idx] = lst->cmp.walk;
+    lst->cmp.walk = idx;
+}
+
+static void compact_move (list_t *lst, ssize_t from, ssize_t to) {
+
+    free_remove (lst, to);
+
+    node_store (lst, to, node_load (lst, from));
+    node_next (lst, node_prev (lst, to)) = to;
+    node_prev (lst, node_next (lst, to)) = to;
+
+    if (lst->ord) {
+
+        ord_move (lst, from, to);
+    }
+
+    if (lst->hash) {
+
+        hash_move (lst, from, to);
+    }
+
+    node_elem (lst, from) = FREE_NODE_ELEM;
+    free_push (lst, from);
+}
+
+/*
+All the nodes are linearized, so the free nodes are exactly
+the ones on positions from *lin* + 1 to *cap*: move one of
+them into the ascending run. Returns true when the run covers
+all of them, which means that the free list is the same as
+the one list_sort () makes
+*/
+
+static bool compact_thread (list_t *lst) {
+
+    compact_t *cmp = &lst->cmp;
+
+    if (cmp->lo > cmp->hi) {
+
+        if (lst->lin == lst->cap) {
+
+            return true;
+        }
+
+        free_remove (lst, lst->lin + 1);
+        free_insert (lst, lst->lin + 1, FICT);
+
+        cmp->lo = lst->lin + 1;
+        cmp->hi = lst->lin + 1;
+        return false;
+    }
+
+    if (cmp->lo > lst->lin + 1) {
+
+        free_remove (lst, cmp->lo - 1);
+        free_insert (lst, cmp->lo - 1, cmp->lo);
+
+        cmp->lo -= 1;
+        return false;
+    }
+
+    if (cmp->hi < lst->cap) {
+
+        free_remove (lst, cmp->hi + 1);
+        free_insert (lst, cmp->hi + 1, FICT);
+
+        cmp->hi += 1;
+        return false;
+    }
+
+    return true;
+}
+
+static void free_remove (list_t *lst, ssize_t idx) {
+
+    compact_t *cmp = &lst->cmp;
+
+    ssize_t prev = cmp->fprev [idx], next = node_next (lst, idx);
+
+    if (prev == FICT) {
+
+        lst->free = next;
+
+    } else {
+
+        node_next (lst, prev) = next;
+    }
+
+    if (next == FICT) {
+
+        cmp->tail = prev;
+
+    } else {
+
+        cmp->fprev [next] = prev;
+    }
+
+    if (cmp->lo <= cmp->hi) {
+
+        if (idx == cmp->lo) {
+
+            cmp->lo += 1;
+
+        } else if (idx == cmp->hi) {
+
+            cmp->hi -= 1;
+        }
+    }
+}
+
+/*
+Writes the never used nodes out as the ascending run at the
+free list's tail that they stand for: the threading that
+construction, growth and the sorts put off, so it costs
+no more than they would have
+*/
+
+static void free_settle (list_t *lst) {
+
+    ssize_t idx = lst->untouched;
+    if (idx > lst->cap) {
+
+        return;
+    }
+
+    for ( ; idx < lst->cap; ++ idx) {
+
+        node_elem (lst, idx) = FREE_NODE_ELEM;
+        node_prev (lst, idx) = FREE_NODE_MARKER;
+        node_next (lst, idx) = idx + 1;
+    }
+    node_elem (lst, idx) = FREE_NODE_ELEM;
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = FICT;
+
+    lst->untouched = lst->cap + 1;
+}
+
+/*
+Links free node *idx* into the free list right
+before node *next* (FICT - to the free list's tail)
+*/
+
+static void free_insert (list_t *lst, ssize_t idx, ssize_t next) {
+
+    compact_t *cmp = &lst->cmp;
+
+    ssize_t prev = (next == FICT) ? cmp->tail : cmp->fprev [next];
+
+    node_next (lst, idx) = next;
+    cmp->fprev [idx] = prev;
+
+    if (prev == FICT) {
+
+        lst->free = idx;
+
+    } else {
+
+        node_next (lst, prev) = idx;
+    }
+
+    if (next == FICT) {
+
+        cmp->tail = idx;
+
+    } else {
+
+        cmp->fprev [next] = idx;
+    }
+}
+
+static ssize_t grown_cap (list_t *lst) {
+
+    double grown = (double) lst->cap * lst->growth.factor + (double) lst->growth.step;
+    ssize_t step = (grown < (double) MAX_CAP) ? (ssize_t) grown - lst->cap : MAX_CAP - lst->cap;
+
+    if (lst->growth.max_step != 0 && step > lst->growth.max_step) {
+
+        step = lst->growth.max_step;
+    }
+
+    return lst->cap + ((step > 0) ? step : 1);
+}
+
+static ssize_t storage_cap (ssize_t cap) {
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+    ssize_t chunks_cap = (cap + CHUNK_SIZE) / CHUNK_SIZE * CHUNK_SIZE - 1;
+    return (chunks_cap <= MAX_CAP) ? chunks_cap : chunks_cap - CHUNK_SIZE;
+
+#else
+
+    return cap;
+
+#endif
+}
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+static bool storage_alloc (list_t *lst, ssize_t cap) {
+
+    lst->n_chunks = (cap + CHUNK_SIZE) / CHUNK_SIZE;
+    lst->dir_cap = lst->n_chunks;
+
+    lst->chunks = (chunk_t **) node_buf_alloc (lst, lst->dir_cap * sizeof (chunk_t *));
+    if (lst->chunks == NULL) {
+
+        return false;
+    }
+
+    for (ssize_t i = 0; i < lst->n_chunks; ++ i) {
+
+        lst->chunks [i] = (chunk_t *) node_buf_alloc (lst, sizeof (chunk_t));
+        if (lst->chunks [i] == NULL) {
+
+            storage_free (lst);
+            return false;
+        }
+    }
+
+    lst->cap = lst->n_chunks * CHUNK_SIZE - 1;
+    return true;
+}
+
+static ssize_t storage_grow (list_t *lst, ssize_t new_cap) {
+
+    ssize_t n_chunks = lst->n_chunks;
+
+    while (n_chunks * CHUNK_SIZE - 1 < new_cap) {
+
+        if (n_chunks == lst->dir_cap) {
+
+            chunk_t **dir_buffer = (chunk_t **) node_buf_realloc (lst, lst->chunks, lst->dir_cap * sizeof (chunk_t *),
+                                                                  lst->dir_cap * sizeof (chunk_t *),
+                                                                  lst->dir_cap * 2 * sizeof (chunk_t *));
+            if (dir_buffer == NULL) {
+
+                return OPER_ERROR_MEM;
+            }
+
+            lst->chunks = dir_buffer;
+            lst->dir_cap *= 2;
+        }
+
+        lst->chunks [n_chunks] = (chunk_t *) node_buf_alloc (lst, sizeof (chunk_t));
+        if (lst->chunks [n_chunks] == NULL) {
+
+            for ( ; n_chunks > lst->n_chunks; -- n_chunks) {
+
+                node_buf_free (lst, lst->chunks [n_chunks - 1], sizeof (chunk_t), false);
+            }
+
+            return OPER_ERROR_MEM;
+        }
+
+        n_chunks += 1;
+    }
+
+    lst->n_chunks = n_chunks;
+    return n_chunks * CHUNK_SIZE - 1;
+}
+
+static ssize_t storage_shrink (list_t *lst, ssize_t new_cap) {
+
+    ssize_t n_chunks = (new_cap + CHUNK_SIZE) / CHUNK_SIZE;
+
+    for ( ; lst->n_chunks > n_chunks; -- lst->n_chunks) {
+
+        node_buf_free (lst, lst->chunks [lst->n_chunks - 1], sizeof (chunk_t), true);
+    }
+
+    return lst->n_chunks * CHUNK_SIZE - 1;
+}
+
+static void storage_free (list_t *lst) {
+
+    for (ssize_t i = 0; i < lst->n_chunks; ++ i) {
+
+#ifndef NDEBUG
+        if (lst->chunks [i]) {
+
+            memset (lst->chunks [i], 0, sizeof (chunk_t));
+        }
+#endif
+
+        node_buf_free (lst, lst->chunks [i], sizeof (chunk_t), false);
+    }
+
+    node_buf_free (lst, lst->chunks, lst->dir_cap * sizeof (chunk_t *), false);
+    lst->chunks = (chunk_t **) OS_RESERVED_ADDR;
+
+    lst->n_chunks = 0;
+    lst->dir_cap = 0;
+}
+
+/*
+Frees the storage of *lst* (through the retire hook,
+if there is one) and takes the storage of *fresh* instead
+*/
+
+static void storage_replace (list_t *lst, list_t *fresh) {
+
+    for (ssize_t i = 0; i < lst->n_chunks; ++ i) {
+
+        node_buf_free (lst, lst->chunks [i], sizeof (chunk_t), true);
+    }
+    node_buf_free (lst, lst->chunks, lst->dir_cap * sizeof (chunk_t *), true);
+
+    lst->chunks = fresh->chunks;
+    lst->n_chunks = fresh->n_chunks;
+    lst->dir_cap = fresh->dir_cap;
+}
+
+#elif defined (LIST_SOA_STORAGE)
+
+static bool storage_alloc (list_t *lst, ssize_t cap) {
+
+    lst->elem = (elem_t *) node_buf_alloc (lst, (cap + 1) * sizeof (elem_t));
+    lst->next = (idx_t *) node_buf_alloc (lst, (cap + 1) * sizeof (idx_t));
+    lst->prev = (idx_t *) node_buf_alloc (lst, (cap + 1) * sizeof (idx_t));
+
+    if (lst->elem == NULL || lst->next == NULL || lst->prev == NULL) {
+
+        node_buf_free (lst, lst->elem, (cap + 1) * sizeof (elem_t), false);
+        node_buf_free (lst, lst->next, (cap + 1) * sizeof (idx_t), false);
+        node_buf_free (lst, lst->prev, (cap + 1) * sizeof (idx_t), false);
+        return false;
+    }
+
+    lst->cap = cap;
+    return true;
+}
+
+static ssize_t storage_grow (list_t *lst, ssize_t new_cap) {
+
+    ssize_t kept = (lst->cap < new_cap) ? lst->cap : new_cap;
+
+    elem_t *elem_buffer = (elem_t *) node_buf_realloc (lst, lst->elem, (lst->cap + 1) * sizeof (elem_t),
+                                                       (kept + 1) * sizeof (elem_t), (new_cap + 1) * sizeof (elem_t));
+    if (elem_buffer == NULL) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    lst->elem = elem_buffer;
+
+    idx_t *next_buffer = (idx_t *) node_buf_realloc (lst, lst->next, (lst->cap + 1) * sizeof (idx_t),
+                                                     (kept + 1) * sizeof (idx_t), (new_cap + 1) * sizeof (idx_t));
+    if (next_buffer == NULL) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    lst->next = next_buffer;
+
+    idx_t *prev_buffer = (idx_t *) node_buf_realloc (lst, lst->prev, (lst->cap + 1) * sizeof (idx_t),
+                                                     (kept + 1) * sizeof (idx_t), (new_cap + 1) * sizeof (idx_t));
+    if (prev_buffer == NULL) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    lst->prev = prev_buffer;
+
+    return new_cap;
+}
+
+static ssize_t storage_shrink (list_t *lst, ssize_t new_cap) {
+
+    return storage_grow (lst, new_cap);             // Shrinking reallocation is no different
+}
+
+static void storage_free (list_t *lst) {
+
+#ifndef NDEBUG
+    memset (lst->elem, 0, (lst->cap + 1) * sizeof (elem_t));
+    memset (lst->next, 0, (lst->cap + 1) * sizeof (idx_t));
+    memset (lst->prev, 0, (lst->cap + 1) * sizeof (idx_t));
+#endif
+
+    node_buf_free (lst, lst->elem, (lst->cap + 1) * sizeof (elem_t), false);
+    node_buf_free (lst, lst->next, (lst->cap + 1) * sizeof (idx_t), false);
+    node_buf_free (lst, lst->prev, (lst->cap + 1) * sizeof (idx_t), false);
+
+    lst->elem = (elem_t *) OS_RESERVED_ADDR;
+    lst->next = (idx_t *) OS_RESERVED_ADDR;
+    lst->prev = (idx_t *) OS_RESERVED_ADDR;
+}
+
+static void storage_replace (list_t *lst, list_t *fresh) {
+
+    node_buf_free (lst, lst->elem, (lst->cap + 1) * sizeof (elem_t), true);
+    node_buf_free (lst, lst->next, (lst->cap + 1) * sizeof (idx_t), true);
+    node_buf_free (lst, lst->prev, (lst->cap + 1) * sizeof (idx_t), true);
+
+    lst->elem = fresh->elem;
+    lst->next = fresh->next;
+    lst->prev = fresh->prev;
+}
+
+#else
+
+static bool storage_alloc (list_t *lst, ssize_t cap) {
+
+    lst->data = (node_t *) node_buf_alloc (lst, (cap + 1) * sizeof (node_t));
+    if (lst->data == NULL) {
+
+        return false;
+    }
+
+    lst->cap = cap;
+    return true;
+}
+
+static ssize_t storage_grow (list_t *lst, ssize_t new_cap) {
+
+    if (lst->map) {
+
+        return map_resize (lst, new_cap) ? new_cap : OPER_ERROR_MEM;
+    }
+
+    ssize_t kept = (lst->cap < new_cap) ? lst->cap : new_cap;
+
+    node_t *buffer = (node_t *) node_buf_realloc (lst, lst->data, (lst->cap + 1) * sizeof (node_t),
+                                                  (kept + 1) * sizeof (node_t), (new_cap + 1) * sizeof (node_t));
+    if (buffer == NULL) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    lst->data = buffer;
+    return new_cap;
+}
+
+static ssize_t storage_shrink (list_t *lst, ssize_t new_cap) {
+
+    return storage_grow (lst, new_cap);             // Shrinking reallocation is no different
+}
+
+static void storage_free (list_t *lst) {
+
+    if (lst->map) {
+
+        map_close (lst);
+        return;
+    }
+
+#ifndef NDEBUG
+    memset (lst->data, 0, (lst->cap + 1) * sizeof (node_t));
+#endif
+
+    node_buf_free (lst, lst->data, (lst->cap + 1) * sizeof (node_t), false);
+    lst->data = (node_t *) OS_RESERVED_ADDR;
+}
+
+static void storage_replace (list_t *lst, list_t *fresh) {
+
+    node_buf_free (lst, lst->data, (lst->cap + 1) * sizeof (node_t), true);
+    lst->data = fresh->data;
+}
+
+#endif
+
+/*
+Buffers that readers may still be looking at (the storage and
+the order index) are reallocated and freed through these: with
+a retire hook set (see list_retire_hook ()) a reallocation
+copies the data to a new buffer and hands the old one over
+to the hook instead of freeing it
+*/
+
+static void *buffer_realloc (list_t *lst, void *buf, size_t copy_size, size_t new_size) {
+
+    if (lst->retire == NULL) {
+
+        return realloc (buf, new_size);
+    }
+
+    void *new_buf = malloc (new_size);
+    if (new_buf == NULL) {
+
+        return NULL;
+    }
+
+    memcpy (new_buf, buf, copy_size);
+    lst->retire (buf, lst->retire_ctx);
+
+    return new_buf;
+}
+
+static void buffer_free (list_t *lst, void *buf) {
+
+    if (lst->retire == NULL) {
+
+        free (buf);
+
+    } else {
+
+        lst->retire (buf, lst->retire_ctx);
+    }
+}
+
+/*
+The storage's buffers go through the list's allocator, if it has
+one (see list_ctor_alloc ()), and through the retire hook otherwise.
+*copy_size* is how much of the buffer the retire hook's copy needs,
+*retire* is set unless the buffer is freed by the destructor
+*/
+
+static void *node_buf_alloc (list_t *lst, size_t size) {
+
+    if (lst->alloc.alloc) {
+
+        return lst->alloc.alloc (size, lst->alloc.ctx);
+    }
+
+    return calloc (1, size);
+}
+
+static void *node_buf_realloc (list_t *lst, void *buf, size_t old_size, size_t copy_size, size_t new_size) {
+
+    if (lst->alloc.grow) {
+
+        return lst->alloc.grow (buf, old_size, new_size, lst->alloc.ctx);
+    }
+
+    return buffer_realloc (lst, buf, copy_size, new_size);
+}
+
+static void node_buf_free (list_t *lst, void *buf, size_t size, bool retire) {
+
+    if (buf == NULL) {
+
+        return;
+    }
+
+    if (lst->alloc.free) {
+
+        lst->alloc.free (buf, size, lst->alloc.ctx);
+
+    } else if (retire) {
+
+        buffer_free (lst, buf);
+
+    } else {
+
+        free (buf);
+    }
+}
+
+/*
+LIST_HUGE_PAGES: anonymous mappings, rounded up to whole huge
+pages once they are at least one huge page long (to whole pages
+before that), so that the kernel can back them with huge pages
+*/
+
+const list_alloc_t LIST_HUGE_PAGES = {huge_alloc, huge_grow, huge_free, NULL};
+
+static size_t huge_len (size_t size) {
+
+    size_t unit = (size >= HUGE_PAGE) ? HUGE_PAGE : (size_t) sysconf (_SC_PAGESIZE);
+    return (size + unit - 1) / unit * unit;
+}
+
+static void *huge_alloc (size_t size, void *ctx) {
+
+    (void) ctx;
+
+    void *buf = mmap (NULL, huge_len (size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge_len (size) >= HUGE_PAGE) {
+
+        madvise (buf, huge_len (size), MADV_HUGEPAGE);      // Only a hint: without THP support the pages stay small
+    }
+#endif
+
+    return buf;
+}
+
+static void *huge_grow (void *buf, size_t old_size, size_t new_size, void *ctx) {
 
-        if (nseq > lst->free - 1) {
+    (void) ctx;
 
-            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
-                    while trying to insert node before node %lld, in function list_seq_insert_before ()\n",
-                    lst->free - 1, nseq);
-            return OPER_ERROR_INP;
-        }
+    if (huge_len (old_size) == huge_len (new_size)) {
 
-        ins_before (lst, nseq, val);
+        return buf;
+    }
 
-        lst->quick_mode = false;
-        return lst->data [nseq].prev;
+    void *new_buf = mremap (buf, huge_len (old_size), huge_len (new_size), MREMAP_MAYMOVE);
+    if (new_buf == MAP_FAILED) {
+
+        return NULL;
     }
 
-    ssize_t idx = FICT, nodes_handled = 0;
-    do {
+#ifdef MADV_HUGEPAGE
+    if (huge_len (new_size) >= HUGE_PAGE) {
 
-        if (nodes_handled == nseq) {
+        madvise (new_buf, huge_len (new_size), MADV_HUGEPAGE);
+    }
+#endif
 
-            ins_before (lst, idx, val);
-            return lst->data [idx].prev;
-        }
+    return new_buf;
+}
 
-        idx = lst->data [idx].next;
-        nodes_handled += 1;
+static void huge_free (void *buf, size_t size, void *ctx) {
 
-    } while (idx != FICT);
+    (void) ctx;
 
-    printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
-            while trying to insert node before node %lld, in function list_seq_insert_before ()\n",
-            nodes_handled - 1, nseq);
-    return OPER_ERROR_INP;
+    munmap (buf, huge_len (size));
 }
 
-ssize_t list_seq_insert_after (list_t *lst, elem_t val, ssize_t nseq) {
+#if !defined (LIST_SEGMENTED_STORAGE) && !defined (LIST_SOA_STORAGE)
 
-    assert (lst);
+static size_t map_len (ssize_t cap) {
 
-#ifdef AUTO_VERIFICATION_ON
+    return (size_t) MAP_HEADER_SIZE + (size_t) (cap + 1) * sizeof (node_t);
+}
 
-    if (list_verify (lst) != NO_FLAWS) {
+static void map_store (list_t *lst, bool clean) {
 
-        DUMP_POSITION();
-        return OPER_ERROR_VER;
-    }
+    map_header_t *map = lst->map;
 
-#endif
+    map->cap = lst->cap;
+    map->free = lst->free;
+    map->untouched = lst->untouched;
+    map->size = lst->size;
+    map->lin = lst->lin;
+    map->ring_head = lst->ring_head;
+    map->quick_mode = lst->quick_mode;
+    map->reversed = lst->reversed;
+    map->clean = clean;
+}
 
-    if (nseq < 0) {
+/*
+The file is extended before the mapping and cut
+after it; the capacity in the header always matches
+the length of the file
+*/
 
-        printf ("\nInsertion failed: *nseq* argument ran below zero while trying to insert \
-                node after node %lld, in function list_seq_insert_after ()\n",
-                nseq);
-        return OPER_ERROR_INP;
-    }
+static bool map_resize (list_t *lst, ssize_t new_cap) {
 
-    if (lst->free == FICT) {
-        
-        if (list_resize_up (lst) == RSZ_MEM_ERROR) {
+    size_t old_len = map_len (lst->cap), new_len = map_len (new_cap);
 
-            printf ("\nResize failed: memory error while trying to resize up \
-                    from capacity %lld to capacity %lld, in function list_seq_insert_after ()\n",
-                    lst->cap, lst->cap * 2 + 1);
-            return OPER_ERROR_MEM;
-        }
+    if (new_len > old_len && ftruncate (lst->map_fd, (off_t) new_len) != 0) {
+
+        return false;
     }
 
-    if (lst->quick_mode) {
+    void *map = mremap (lst->map, old_len, new_len, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) {
 
-        if (nseq > lst->free - 1) {
+        if (new_len > old_len && ftruncate (lst->map_fd, (off_t) old_len) != 0) {
 
-            printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
-                    while trying to insert node after node %lld, in function list_seq_insert_after ()\n",
-                    lst->free - 1, nseq);
-            return OPER_ERROR_INP;
+            printf ("\nFile-backed storage: can't cut the file back after a failed remapping\n");
         }
 
-        ins_after (lst, nseq, val);
-
-        lst->quick_mode = false;
-        return lst->data [nseq].next;
+        return false;
     }
 
-    ssize_t idx = FICT, nodes_handled = 0;
-    do {
+    if (new_len < old_len && ftruncate (lst->map_fd, (off_t) new_len) != 0) {
 
-        if (nodes_handled == nseq) {
+        printf ("\nFile-backed storage: can't cut the file after shrinking\n");
+    }
 
-            ins_after (lst, idx, val);
+    lst->map = (map_header_t *) map;
+    lst->data = (node_t *) ((char *) map + MAP_HEADER_SIZE);
+    lst->map->cap = new_cap;
 
-            return lst->data [idx].next;
-        }
+    return true;
+}
 
-        idx = lst->data [idx].next;
-        nodes_handled += 1;
+static void map_close (list_t *lst) {
 
-    } while (idx != FICT);
+    map_store (lst, true);
 
-    printf ("\nInsertion failed: *nseq* argument exceeds sequence's real size (%lld) \
-            while trying to insert node before node %lld, in function list_seq_insert_after ()\n",
-            nodes_handled - 1, nseq);
-    return OPER_ERROR_INP;
-}
+    munmap (lst->map, map_len (lst->cap));
+    flock (lst->map_fd, LOCK_UN);
+    close (lst->map_fd);
 
-DEL_SQ_OPER_CODE list_seq_delete (list_t *lst, ssize_t nseq) {
+    lst->map = NULL;
+    lst->map_fd = -1;
+    lst->data = (node_t *) OS_RESERVED_ADDR;
+}
 
-    assert (lst);
+/*
+O(1): the format, the length of the file and
+the ranges of the header's fields and of the
+fictional node's links
+*/
 
-#ifdef AUTO_VERIFICATION_ON
+static bool map_header_valid (map_header_t *hdr, size_t file_size) {
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (hdr->magic != MAP_MAGIC || hdr->version != MAP_VERSION) {
 
-        DUMP_POSITION();
-        return DEL_SQ_VER_FAILED;
+        printf ("\nOpening failed: not a list file or an unknown format version\n");
+        return false;
     }
 
-#endif
+    if (hdr->node_size != sizeof (node_t)) {
 
-    if (nseq < 0) {
+        printf ("\nOpening failed: the file's nodes are %u bytes long instead of %zu \
+                (elem_t or LIST_COMPACT_IDX differ)\n", hdr->node_size, sizeof (node_t));
+        return false;
+    }
 
-        printf ("\nDeletion failed: *nseq* argument ran below zero while trying to delete \
-                node %lld, in function list_seq_delete ()\n",
-                nseq);
-        return DEL_SQ_WRONG_INPUT;
+    if (hdr->cap < 0 || hdr->cap > MAX_CAP || map_len (hdr->cap) != file_size) {
+
+        printf ("\nOpening failed: capacity %lld doesn't match the length of the file (%zu)\n",
+                (ssize_t) hdr->cap, file_size);
+        return false;
     }
 
-    if (nseq == FICT) {
+    if (hdr->size < 0 || hdr->size > hdr->cap || hdr->free < 0 || hdr->free > hdr->cap ||
+        (hdr->free == FICT) != (hdr->size == hdr->cap) || hdr->untouched <= hdr->size ||
+        hdr->untouched > hdr->cap + 1 || (hdr->ring_head != FICT && hdr->untouched <= hdr->cap) ||
+        hdr->lin < 0 || hdr->lin > hdr->size ||
+        hdr->ring_head < 0 || hdr->ring_head > hdr->cap || (hdr->quick_mode && hdr->ring_head != FICT)) {
 
-        printf ("\nDeletion failed: *nseq* argument is pointing at a base fictive node \
-                while trying to delete node %lld, in function list_seq_delete ()\n", 
-                nseq);
-        return DEL_SQ_WRONG_INPUT;
+        printf ("\nOpening failed: the header's fields are out of their ranges\n");
+        return false;
     }
 
-    if (lst->quick_mode) {
+    node_t *fict = (node_t *) ((char *) hdr + MAP_HEADER_SIZE);
+    if (fict->next < 0 || fict->next > hdr->cap || fict->prev < 0 || fict->prev > hdr->cap ||
+        (fict->next == FICT) != (hdr->size == 0)) {
 
-        if (lst->free) {
+        printf ("\nOpening failed: the fictional node's links are out of their range\n");
+        return false;
+    }
 
-            if (nseq >= lst->free) {
+    return true;
+}
 
-                printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
-                        while trying to delete node %lld, in function list_seq_delete ()\n",
-                        lst->free - 1, nseq);
-                return DEL_SQ_WRONG_INPUT;
-            }
-        } else {
+#endif
 
-            if (nseq > lst->cap) {
+static node_t node_load (list_t *lst, ssize_t idx) {
 
-                printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
-                        while trying to delete node %lld, in function list_seq_delete ()\n",
-                        lst->cap, nseq);
-                return DEL_SQ_WRONG_INPUT;
-            }
-        }
+    node_t node = {node_elem (lst, idx), node_next (lst, idx), node_prev (lst, idx)};
+    return node;
+}
 
-        del (lst, nseq);
+static void node_store (list_t *lst, ssize_t idx, node_t node) {
 
-        lst->quick_mode = false;
-        return SQ_DELETED;
-    }
+    node_elem (lst, idx) = node.elem;
+    node_next (lst, idx) = node.next;
+    node_prev (lst, idx) = node.prev;
+}
 
-    ssize_t idx = FICT, nodes_handled = 0;
-    do {
+/*
+Copies *n* elements starting from the node *idx* in the order
+of the list, returns the node after them. In the quick mode
+the nodes are just the next positions
+*/
 
-        if (nodes_handled == nseq) {
+static ssize_t stream_gather (list_t *lst, ssize_t idx, elem_t *elems, ssize_t n) {
 
-            del (lst, idx);
+    if (lst->quick_mode && !lst->reversed) {
 
-            return SQ_DELETED;
+        for (ssize_t i = 0; i < n; ++ i) {
+
+            elems [i] = node_elem (lst, idx + i);
         }
 
-        idx = lst->data [idx].next;
-        nodes_handled += 1;
+        return idx + n;
+    }
 
-    } while (idx != FICT);
+    for (ssize_t i = 0; i < n; ++ i) {
 
-    printf ("\nDeletion failed: *nseq* argument exceeds sequence's real size (%lld) \
-            while trying to delete node %lld, in function list_seq_delete ()\n",
-            nodes_handled, nseq);
-    return DEL_SQ_WRONG_INPUT;
+        elems [i] = node_elem (lst, idx);
+        idx = list_next (lst, idx);
+    }
+
+    return idx;
 }
 
-VERIFICATION_CODE list_verify (list_t *lst) {
+/*
+Packs a block: the number of elements and the length of
+the varints, then the varints of zigzag-encoded differences
+between neighbouring elements (*last* is the element before
+the block). Returns the length of the whole block
+*/
 
-    assert (lst);
+static size_t stream_pack (const elem_t *elems, ssize_t n, elem_t *last, uint8_t *bytes) {
 
-    if (lst->data == NULL) {
+    uint8_t *out = bytes + BLOCK_HEADER;
+    uelem_t prev = (uelem_t) *last;
 
-        printf ("\nVerification failed: list's *data* pointer is NULL\n");
-        return DATA_FLAW;
-    }
+    for (ssize_t i = 0; i < n; ++ i) {
 
-    if (lst->cap < 0) {
+        uelem_t delta = (uelem_t) elems [i] - prev;
+        uelem_t zigzag = (uelem_t) (delta << 1) ^ (uelem_t) (0 - (delta >> (ELEM_BITS - 1)));
 
-        printf ("\nVerification failed: list's *capacity* parameter ran below zero (%lld)\n", lst->cap);
-        return CAP_FLAW;
-    }
+        while (zigzag >= 0x80) {
 
-    if (lst->free < 0) {
+            *out ++ = (uint8_t) (zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        *out ++ = (uint8_t) zigzag;
 
-        printf ("\nVerification failed: list's *free* index ran below zero (%lld)\n", lst->free);
-        return FREE_FLAW;
+        prev = (uelem_t) elems [i];
     }
 
-    if (!((lst->data [FICT].next > 0 && lst->data [FICT].next <= lst->cap &&
-        lst->data [FICT].prev > 0 && lst->data [FICT].prev <= lst->cap) ||
-        (lst->data [FICT].next == 0 && lst->data [FICT].prev == 0))) {
-
-        printf ("\nVerification failed: list's fictional node has an impossible \
-                parameters combination (next: %lld; prev: %lld; list's capacity: %lld)\n",
-                lst->data [FICT].next, lst->data [FICT].prev, lst->cap);
-        return FICT_FLAW;
-    }
+    *last = (elem_t) prev;
 
-    ssize_t nodes_handled = 0, idx = FICT;
-    do {
+    uint32_t block [2] = {(uint32_t) n, (uint32_t) (out - bytes - BLOCK_HEADER)};
+    memcpy (bytes, block, sizeof (block));
 
-        if (lst->data [idx].next > lst->cap || lst->data [idx].next < 0) {
+    return (size_t) (out - bytes);
+}
 
-            printf ("\nVerification failed: the node next to the one \
-                    on position %lld has an impossible index: %lld (number %lld in the order of the list)\n",
-                    idx, lst->data [idx].next, nodes_handled + 1);
-            return LST_IDX_FLAW;
-        }
+/*
+Unpacks the varints of a block (without its header), returns
+false if they don't make exactly *n* elements
+*/
 
-        if (lst->data [lst->data [idx].next].prev != idx) {
+static bool stream_unpack (const uint8_t *bytes, size_t len, elem_t *elems, ssize_t n, elem_t *last) {
 
-            printf ("\nVerification failed: incongruity of next and prev parameters \
-                    detected during the transition from the node on position %lld to the node \
-                    on position %lld (number %lld and %lld in the order of the list)\n",
-                    idx, lst->data [idx].next, nodes_handled, nodes_handled + 1);
-            return LST_SEQUENCE_FLAW;
-        }
+    const uint8_t *end = bytes + len;
+    uelem_t prev = (uelem_t) *last;
 
-        idx = lst->data [idx].next;
-        nodes_handled += 1;
+    for (ssize_t i = 0; i < n; ++ i) {
 
-    } while (idx != FICT);
+        uelem_t zigzag = 0;
+        for (unsigned shift = 0; ; shift += 7) {
 
-    idx = lst->free;
-    for (ssize_t free_nodes_handled = 0; idx != FICT;
-        ++ nodes_handled, ++ free_nodes_handled, idx = lst->data [idx].next) {
+            if (bytes == end || shift >= ELEM_BITS) {
 
-        if (lst->data [idx].prev != FREE_NODE_MARKER) {
+                return false;
+            }
 
-            printf ("\nVerification failed: the free node on position %lld has \
-                    no *free node* marker (prev: %lld; number %lld in the order of the free list)\n",
-                    idx, lst->data [idx].prev, free_nodes_handled + 1);
-            return FREE_MARKER_FLAW;
-        }
+            uint8_t byte = *bytes ++;
+            zigzag |= (uelem_t) (byte & 0x7f) << shift;
 
-        if (lst->data [idx].next > lst->cap || lst->data [idx].next < 0) {
+            if (byte < 0x80) {
 
-            printf ("\nVerification failed: the free node next to the one on position %lld has \
-                    an impossible index: %lld (number %lld in the order of the free list)\n",
-                    idx, lst->data [idx].next, free_nodes_handled + 1);
-            return FREE_IDX_FLAW;
+                break;
+            }
         }
-    }
 
-    if (nodes_handled != lst->cap + 1) {
-
-        printf ("\nVerification failed: number of nodes in main and free \
-                sequences doesn't match list's capacity (%lld against %lld)\n",
-                nodes_handled, lst->cap);
-        return INCOMPLETENESS_FLAW;
+        prev += (zigzag >> 1) ^ (uelem_t) (0 - (zigzag & 1));
+        elems [i] = (elem_t) prev;
     }
 
-    return NO_FLAWS;
-}
+    *last = (elem_t) prev;
 
-DUMP_OPER_CODE list_dump (list_t *lst, const char *file_name) {
+    return bytes == end;
+}
 
-    assert (lst);
-    assert (file_name);
+/*
+Copies the fictional node and the nodes of the window
+(*radius* < 0 means the whole array) to a new dump job
+*/
 
-#ifdef AUTO_VERIFICATION_ON
+static DUMP_OPER_CODE dump_snapshot (list_t *lst, const char *file_name, ssize_t pos, ssize_t radius, dump_job_t **job) {
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (pos < 0 || pos > lst->cap) {
 
-        DUMP_POSITION();
-        return DMP_VER_FAILED;
+        printf ("\nDump failed: position %lld is out of the range [0; %lld]\n", pos, lst->cap);
+        return DMP_WRONG_INPUT;
     }
 
-#endif
-
-    if (strlen (file_name) > 30) {
+    ssize_t lo = 1, hi = lst->cap;
+    if (radius >= 0 && radius < lst->cap) {
 
-        printf ("\nDump failed: impossible dump file name\n");
-        return COMMON_DMP_ERROR;
+        lo = (pos - radius > 1) ? pos - radius : 1;
+        hi = (pos + radius < lst->cap) ? pos + radius : lst->cap;
     }
 
-    FILE *dump_file = fopen ("list_dump_instr.gv", "w");
+    ssize_t n = (hi >= lo) ? hi - lo + 1 : 0;
 
-    if (dump_file == NULL) {
+    dump_job_t *snap = (dump_job_t *) calloc (1, sizeof (dump_job_t));
+    node_t *nodes = (node_t *) calloc (n + 1, sizeof (node_t));
+    char *name = strdup (file_name);
 
-        printf ("\nDump failed: failed to open the dump instruction file\n");
-        return COMMON_DMP_ERROR;
-    }
+    if (snap == NULL || nodes == NULL || name == NULL) {
 
-    fputs ("digraph dump{\n\trankdir=TB;\n\t{\n\t\tnode[shape=plaintext];\
-            \n\t\tedge[color=white];\n\t\t\"cell 0 (FICT)\"", dump_file);
-    for (ssize_t i = 1; i <= lst->cap; ++ i) {
+        printf ("\nDump failed: memory error\n");
 
-        fprintf (dump_file, " -> \"cell %lld\"", i);
+        free (snap);
+        free (nodes);
+        free (name);
+        return COMMON_DMP_ERROR;
     }
-    fprintf (dump_file, ";\n\t}\n\t");
-    for (ssize_t i = 0; i <= lst->cap; ++ i) {
 
-        fprintf (dump_file, "%lld [shape=record,label=\" elem %d | <next> next %lld | <prev> prev %lld\"];\n\t",
-                 i, lst->data [i].elem, lst->data [i].next, lst->data [i].prev);
-    }
-    fprintf (dump_file, "{ rank = same; \"cell 0 (FICT)\"; 0; free; }\n\t");
-    for (ssize_t i = 1; i <= lst->cap; ++ i) {
+    nodes [0] = node_load (lst, FICT);
 
-        fprintf (dump_file, "{ rank = same; \"cell %lld\"; %lld; }\n\t", i, i);
-    }
-    fputs ("{\n\t\tedge[color=orange];\n\t\t0:<next> -> ", dump_file);
-    for (ssize_t idx = lst->data [FICT].next; idx != FICT; idx = lst->data [idx].next) {
+#if !defined (LIST_SEGMENTED_STORAGE) && !defined (LIST_SOA_STORAGE)
+    memcpy (nodes + 1, lst->data + lo, n * sizeof (node_t));
+#else
+    for (ssize_t i = 0; i < n; ++ i) {
 
-        fprintf (dump_file, "%lld:<next> -> ", idx);
+        nodes [i + 1] = node_load (lst, lo + i);
     }
-    fputs ("0:<next>;\n\t}\n\t{\n\t\tedge[color=purple];\n\t\t0:<prev> -> ", dump_file);
-    for (ssize_t idx = lst->data [FICT].prev; idx != FICT; idx = lst->data [idx].prev) {
+#endif
 
-        fprintf (dump_file, "%lld:<prev> -> ", idx);
-    }
-    fputs ("0:<prev>;\n\t}\n\t", dump_file);
-    if (lst->free) {
-        
-        fprintf (dump_file, "{\n\t\tedge[color=lightgreen];\n\t\t%lld:<next> -> ", lst->free);
-        for (ssize_t idx = lst->data [lst->free].next; idx != FICT; idx = lst->data [idx].next) {
+    for (ssize_t idx = (lst->untouched > lo) ? lst->untouched : lo; idx <= hi; ++ idx) {
 
-            fprintf (dump_file, "%lld:<next> -> ", idx);
-        }
-        fputs("0:<next>;\n\t}\n\t", dump_file);
+        nodes [idx - lo + 1] = {FREE_NODE_ELEM, (idx < lst->cap) ? (idx_t) (idx + 1) : (idx_t) FICT, FREE_NODE_MARKER};    // Never used nodes as the free list links them
     }
-    fprintf (dump_file, "{\n\t\tedge[color=darkgreen]\n\t\tfree -> %lld;\n\t}\n}\n", lst->free);
-
-    fclose (dump_file);
 
-    char *cmd = (char *) calloc (64, sizeof (char));
-    sprintf (cmd, "dot -Tpng list_dump_instr.gv -o %s", file_name);
-    system (cmd);
-    free (cmd);
+    snap->file_name = name;
+    snap->lo = lo;
+    snap->hi = lo + n - 1;
+    snap->free = lst->free;
+    snap->nodes = nodes;
 
+    *job = snap;
     return DUMPED;
 }
 
-SORT_OPER_CODE list_sort (list_t *lst) {
+/*
+Writes the graph of a snapshot to a unique temporary file
+and runs dot on it (without a shell, so any file name will do)
+*/
 
-    assert (lst);
+static bool dump_render (dump_job_t *job) {
 
-#ifdef AUTO_VERIFICATION_ON
+    char gv_name [] = "/tmp/list_dump_XXXXXX";
+    int fd = mkstemp (gv_name);
+    FILE *gv = (fd < 0) ? NULL : fdopen (fd, "w");
 
-    if (list_verify (lst) != NO_FLAWS) {
+    if (gv == NULL) {
 
-        DUMP_POSITION();
-        return SRT_VER_FAILED;
+        printf ("\nDump failed: failed to create the dump instruction file\n");
+
+        if (fd >= 0) {
+
+            close (fd);
+            unlink (gv_name);
+        }
+        return false;
     }
 
-#endif
+    dump_write (job, gv);
 
-    ssize_t idx = lst->data [FICT].next, nseq = 1;
-    for ( ; idx != FICT; ++ nseq) {
+    bool written = !ferror (gv);
+    written = (fclose (gv) == 0) && written;
 
-        node_swap (lst, idx, nseq);
-        idx = lst->data [nseq].next;
-    }
+    if (!written) {
 
-    lst->free = nseq;
-    for ( ; nseq < lst->cap; ++ nseq) {
+        printf ("\nDump failed: failed to write the dump instruction file\n");
 
-        lst->data [nseq].prev = FREE_NODE_MARKER;
-        lst->data [nseq].next = nseq + 1;
+        unlink (gv_name);
+        return false;
     }
-    if (nseq == lst->cap) {
 
-        lst->data [nseq].prev = FREE_NODE_MARKER;
-        lst->data [nseq].next = FICT;
-    } else {
+    char *argv [] = {(char *) "dot", (char *) "-Tpng", gv_name, (char *) "-o", job->file_name, NULL};
+    pid_t pid = 0;
+    int status = 0;
 
-        lst->free = FICT;
+    bool drawn = posix_spawnp (&pid, "dot", NULL, NULL, argv, environ) == 0 &&
+                 waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+    unlink (gv_name);
+
+    if (!drawn) {
+
+        printf ("\nDump failed: dot couldn't render %s\n", job->file_name);
     }
 
-    lst->quick_mode = true;
-    return SORTED;
+    return drawn;
 }
 
-static void node_swap (list_t *lst, ssize_t idx1, ssize_t idx2) {
+static void dump_write (dump_job_t *job, FILE *gv) {
 
-    assert (lst);
-    assert (idx1 > 0);
-    assert (idx2 > 0);
-    assert (idx1 <= lst->cap);
-    assert (idx2 <= lst->cap);
+    ssize_t n = job->hi - job->lo + 1;
 
-    lst->data [lst->data [idx1].prev].next = idx2;
-    lst->data [lst->data [idx1].next].prev = idx2;
-    if (lst->data [idx2].prev != -1) {              // Same verification for idx1 is unnecessary, because sorting func uses swap only for idx1 = idx and idx2 = nseq and idx cannot point at a free node
-        
-        lst->data [lst->data [idx2].prev].next = idx1;
-        lst->data [lst->data [idx2].next].prev = idx1;
+    auto shown = [job] (ssize_t idx) { return idx == FICT || (idx >= job->lo && idx <= job->hi); };
+    auto pos = [job] (ssize_t i) { return (i == 0) ? (ssize_t) FICT : (ssize_t) (job->lo + i - 1); };
+
+    fputs ("digraph dump{\n\trankdir=TB;\n\t{\n\t\tnode[shape=plaintext];\
+            \n\t\tedge[color=white];\n\t\t\"cell 0 (FICT)\"", gv);
+    for (ssize_t idx = job->lo; idx <= job->hi; ++ idx) {
+
+        fprintf (gv, " -> \"cell %lld\"", idx);
     }
+    fprintf (gv, ";\n\t}\n\t");
+    for (ssize_t i = 0; i <= n; ++ i) {
 
-    node_t temp_nd = {};
-    temp_nd = lst->data [idx1];
-    lst->data [idx1] = lst->data [idx2];
-    lst->data [idx2] = temp_nd;
-}
+        fprintf (gv, "%lld [shape=record,label=\" elem %d | <next> next %lld | <prev> prev %lld\"];\n\t",
+                 pos (i), job->nodes [i].elem, (ssize_t) job->nodes [i].next, (ssize_t) job->nodes [i].prev);
+    }
+    fprintf (gv, "{ rank = same; \"cell 0 (FICT)\"; 0; free; }\n\t");
+    for (ssize_t idx = job->lo; idx <= job->hi; ++ idx) {
 
-static void ins_before (list_t *lst, ssize_t idx, elem_t val) {
+        fprintf (gv, "{ rank = same; \"cell %lld\"; %lld; }\n\t", idx, idx);
+    }
 
-    lst->data [lst->data [idx].prev].next = lst->free;
-    lst->free = lst->data [lst->free].next;
-    lst->data [lst->data [lst->data [idx].prev].next].prev = lst->data [idx].prev;
-    lst->data [lst->data [lst->data [idx].prev].next].next = idx;
-    lst->data [lst->data [lst->data [idx].prev].next].elem = val;
-    lst->data [idx].prev = lst->data [lst->data [idx].prev].next;
-}
+    /* The links of the list's nodes, the previous ones and the ones of the free list */
 
-static void ins_after (list_t *lst, ssize_t idx, elem_t val) {
+    const char *colors [3] = {"orange", "purple", "lightgreen"};
+    for (int group = 0; group < 3; ++ group) {
 
-    lst->data [lst->data [idx].next].prev = lst->free;
-    lst->free = lst->data [lst->free].next;
-    lst->data [lst->data [lst->data [idx].next].prev].next = lst->data [idx].next;
-    lst->data [lst->data [lst->data [idx].next].prev].prev = idx;
-    lst->data [lst->data [lst->data [idx].next].prev].elem = val;
-    lst->data [idx].next = lst->data [lst->data [idx].next].prev;
-}
+        fprintf (gv, "{\n\t\tedge[color=%s];", colors [group]);
+        for (ssize_t i = 0; i <= n; ++ i) {
+
+            node_t *node = job->nodes + i;
+            ssize_t to = (group == 1) ? node->prev : node->next;
+
+            if ((node->prev == FREE_NODE_MARKER) == (group == 2) && shown (to)) {
+
+                fprintf (gv, (group == 1) ? "\n\t\t%lld:<prev> -> %lld:<prev>;" : "\n\t\t%lld:<next> -> %lld:<next>;",
+                         pos (i), to);
+            }
+        }
+        fputs ("\n\t}\n\t", gv);
+    }
 
-static void del (list_t *lst, ssize_t idx) {
+    if (shown (job->free)) {
 
-    lst->data [idx].elem = FREE_NODE_ELEM;
-    lst->data [lst->data [idx].next].prev = lst->data [idx].prev;
-    lst->data [lst->data [idx].prev].next = lst->data [idx].next;
-    lst->data [idx].prev = FREE_NODE_MARKER;
-    lst->data [idx].next = lst->free;
-    lst->free = idx;
+        fprintf (gv, "{\n\t\tedge[color=darkgreen]\n\t\tfree -> %lld;\n\t}\n", job->free);
+    }
+    fputs ("}\n", gv);
 }
 
-static void del_head (list_t *lst) {
+static void dump_free (dump_job_t *job) {
 
-    lst->data [FICT].next = lst->data [lst->data [FICT].next].next;
-    lst->data [lst->data [lst->data [FICT].next].prev].next = lst->free;
-    lst->data [lst->data [lst->data [FICT].next].prev].prev = FREE_NODE_MARKER;
-    lst->free = lst->data [lst->data [FICT].next].prev;
-    lst->data [lst->data [lst->data [FICT].next].prev].elem = FREE_NODE_ELEM;
-    lst->data [lst->data [FICT].next].prev = FICT;
+    free (job->file_name);
+    free (job->nodes);
+    free (job);
 }
 
-static void del_tail (list_t *lst) {
+/*
+The queue is never destroyed: the detached thread may
+still be waiting on it while static objects are destroyed
+*/
 
-    lst->data [FICT].prev = lst->data [lst->data [FICT].prev].prev;
-    lst->data [lst->data [lst->data [FICT].prev].next].prev = FREE_NODE_MARKER;
-    lst->data [lst->data [lst->data [FICT].prev].next].next = lst->free;
-    lst->free = lst->data [lst->data [FICT].prev].next;
-    lst->data [lst->data [lst->data [FICT].prev].next].elem = FREE_NODE_ELEM;
-    lst->data [lst->data [FICT].prev].next = FICT;
+static dump_queue_t *dump_queue () {
+
+    static dump_queue_t *queue = new dump_queue_t ();
+    return queue;
 }
 
-static RESIZE_OPER_CODE list_resize_up (list_t *lst) {
+static void dump_worker (dump_queue_t *queue) {
 
-    ssize_t old_cap = lst->cap;
-    node_t *buffer = (node_t *) realloc (lst->data, (old_cap * 2 + 2) * sizeof (node_t));
-    if (buffer) {
-        
-        lst->cap = old_cap * 2 + 1;
+    std::unique_lock<std::mutex> lock (queue->mutex);
 
-    } else {
-        
-        return RSZ_MEM_ERROR;
-    }
+    while (true) {
 
-    lst->free = old_cap + 1;
-    ssize_t idx = lst->free;
-    for ( ; idx < lst->cap; ++ idx) {
+        queue->wake.wait (lock, [queue] { return !queue->jobs.empty (); });
 
-        lst->data [idx].elem = FREE_NODE_ELEM;
-        lst->data [idx].prev = FREE_NODE_MARKER;
-        lst->data [idx].next = idx + 1;
+        dump_job_t *job = queue->jobs.front ();
+        queue->jobs.pop_front ();
+
+        lock.unlock ();
+        dump_render (job);
+        dump_free (job);
+        lock.lock ();
+
+        queue->pending -= 1;
+        queue->done.notify_all ();
     }
-    lst->data [idx].elem = FREE_NODE_ELEM;
-    lst->data [idx].prev = FREE_NODE_MARKER;
-    lst->data [idx].next = FICT;
-    
-    return RESIZED;
 }
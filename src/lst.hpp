@@ -2,13 +2,26 @@
 #define LIST_ACTIVE
 
 #define AUTO_VERIFICATION_ON
+// #define LIST_SEGMENTED_STORAGE
+// #define LIST_COMPACT_IDX
+// #define LIST_SOA_STORAGE
+// #define LIST_VER_LEVEL VER_LOCAL
 
 #include <stdio.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <malloc.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 
 constexpr int OS_RESERVED_ADDR = 13;
+constexpr ssize_t CACHE_LINE = 64;
+
+#define DUMP_POSITION()                                                             \
+    do {                                                                            \
+        printf("^^^ %s : %s : %d ^^^\n", __FILE__, __PRETTY_FUNCTION__, __LINE__);  \
+    } while (0)
 
 enum CTOR_OPER_CODE {CTOR_MEM_ERROR = 0, CONSTRUCTED = 1};
 enum DEL_FR_OPER_CODE {HEAD_DELETED = 0, NO_HEAD_TO_DELETE = 1, DEL_FR_VER_FAILED = 2};
@@ -16,37 +29,447 @@ enum DEL_BK_OPER_CODE {TAIL_DELETED = 0, NO_TAIL_TO_DELETE = 1, DEL_BK_VER_FAILE
 enum DEL_OPER_CODE    {DELETED = 0, DEL_VER_FAILED = 2, DEL_WRONG_INPUT = 3};
 enum DEL_SQ_OPER_CODE {SQ_DELETED = 0, DEL_SQ_VER_FAILED = 2, DEL_SQ_WRONG_INPUT = 3};
 enum SORT_OPER_CODE {SORTED = 0, SRT_VER_FAILED = 2};
-enum DUMP_OPER_CODE {DUMPED = 0, COMMON_DMP_ERROR = 1, DMP_VER_FAILED = 2};
+enum DUMP_OPER_CODE {DUMPED = 0, COMMON_DMP_ERROR = 1, DMP_VER_FAILED = 2, DMP_WRONG_INPUT = 3};
+enum ORD_OPER_CODE {ORD_MEM_ERROR = 0, ORD_ON = 1};
+enum RESERVE_OPER_CODE {RSV_MEM_ERROR = 0, RESERVED = 1, RSV_VER_FAILED = 2};
+enum SHRINK_OPER_CODE {SHR_MEM_ERROR = 0, SHRUNK = 1, SHR_VER_FAILED = 2};
+enum RESIZE_OPER_CODE {RSZ_MEM_ERROR = 0, RESIZED = 1};
+enum COMPACT_OPER_CODE {CMP_MEM_ERROR = 0, COMPACTING = 1, COMPACTED = 2, CMP_VER_FAILED = 3};
+enum ROTATE_OPER_CODE {ROTATED = 0, ROT_VER_FAILED = 2};
+enum HASH_OPER_CODE {HASH_MEM_ERROR = 0, HASH_ON = 1};
+enum DEL_VAL_OPER_CODE {VAL_DELETED = 0, NO_VAL_TO_DELETE = 1, DEL_VAL_VER_FAILED = 2};
+enum MOVE_OPER_CODE {MOVED = 0, MOV_VER_FAILED = 2, MOV_WRONG_INPUT = 3};
+enum OPEN_OPER_CODE {OPEN_FILE_ERROR = 0, OPENED = 1, OPEN_FORMAT_ERROR = 2, OPEN_VER_FAILED = 3};
+enum SAVE_OPER_CODE {SAVE_IO_ERROR = 0, SAVED = 1, SAVE_VER_FAILED = 2, SAVE_MEM_ERROR = 3};
+enum LOAD_OPER_CODE {LOAD_IO_ERROR = 0, LOADED = 1, LOAD_FORMAT_ERROR = 2, LOAD_MEM_ERROR = 3};
 enum VERIFICATION_CODE {NO_FLAWS, DATA_FLAW, CAP_FLAW, FREE_FLAW, FICT_FLAW, LST_IDX_FLAW,
-                        LST_SEQUENCE_FLAW, FREE_MARKER_FLAW, FREE_IDX_FLAW, INCOMPLETENESS_FLAW};
+                        LST_SEQUENCE_FLAW, FREE_MARKER_FLAW, FREE_IDX_FLAW, INCOMPLETENESS_FLAW,
+                        ORD_FLAW, PREFIX_FLAW, FREE_BACK_FLAW, SIZE_FLAW, RING_FLAW, HASH_FLAW,
+                        UNTOUCHED_FLAW};
 
 constexpr ssize_t OPER_ERROR_MEM = -1;
 constexpr ssize_t OPER_ERROR_VER = -2;
 constexpr ssize_t OPER_ERROR_INP = -3;
 
+enum VER_LEVEL {VER_OFF = 0, VER_LOCAL = 1, VER_SAMPLED = 2, VER_FULL = 3};
+
+/*
+Verification level new lists get (see list_verify_level ()).
+The levels only matter with AUTO_VERIFICATION_ON defined;
+without it nothing is verified automatically at all
+*/
+
+#ifndef LIST_VER_LEVEL
+#define LIST_VER_LEVEL VER_FULL
+#endif
+
+constexpr ssize_t VER_SAMPLE_SIZE = 16;
+
 enum ELEM_VALUES {FREE_NODE_ELEM = 0, FICT_NODE_ELEM = -1};
 enum SPECIAL_IDX {FREE_NODE_MARKER = -1, NO_HEAD = 0, NO_TAIL = 0, FICT = 0};
 
 typedef int elem_t;
 
+/*
+Type of the indexes stored inside the nodes (and the side
+arrays). With LIST_COMPACT_IDX defined they are 32-bit, which
+makes a node take 12 bytes instead of 24 and limits the
+capacity to MAX_CAP. The functions' arguments and return
+values are ssize_t regardless
+*/
+
+#ifdef LIST_COMPACT_IDX
+
+typedef int32_t idx_t;
+constexpr ssize_t MAX_CAP = INT32_MAX - 1;
+
+#else
+
+typedef ssize_t idx_t;
+constexpr ssize_t MAX_CAP = SSIZE_MAX / 2 - 1;
+
+#endif
+
+/*
+With LIST_SEGMENTED_STORAGE defined nodes are stored in
+chunks of CHUNK_SIZE nodes each, addressed through a chunk
+directory. Growth adds a new chunk and never moves existing
+nodes; capacity is always a whole number of chunks minus
+the fictional node
+*/
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+#ifndef LIST_CHUNK_SHIFT
+#define LIST_CHUNK_SHIFT 12
+#endif
+
+constexpr ssize_t CHUNK_SIZE = (ssize_t) 1 << LIST_CHUNK_SHIFT;
+constexpr ssize_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+#endif
+
 struct node_t {
 
     elem_t elem;
-    ssize_t next;
-    ssize_t prev;
+    idx_t next;
+    idx_t prev;
+};
+
+/*
+With LIST_SOA_STORAGE defined nodes' fields are stored in
+three parallel arrays (or, with segmented storage, in three
+parallel arrays inside every chunk) instead of an array of
+node_t, so walks over the links don't pull the elements
+into cache and scans over the elements don't pull the links
+*/
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+#ifdef LIST_SOA_STORAGE
+
+struct chunk_t {
+
+    elem_t elem [CHUNK_SIZE];
+    idx_t next [CHUNK_SIZE];
+    idx_t prev [CHUNK_SIZE];
+};
+
+#else
+
+struct chunk_t {
+
+    node_t node [CHUNK_SIZE];
+};
+
+#endif
+
+#endif
+
+/*
+Order-statistics index: an implicit treap over node indices,
+stored in a side array parallel to *data* (ord [idx] describes
+data [idx]). In-order traversal of the treap gives the order
+of the list, so logical numbers are mapped to real positions
+in O(log n) even out of the quick mode. Index FICT is never
+a member of the treap and plays the role of the empty subtree
+*/
+
+struct ord_node_t {
+
+    idx_t left;
+    idx_t right;
+    idx_t parent;
+    idx_t size;
+    unsigned prio;
+};
+
+/*
+Incremental compaction state. Nodes are moved to their
+final positions one by one, and free nodes that have to be
+taken out of the middle of the free list are unlinked using
+*fprev* back links. The back links are collected with a walk
+over the free list (*walk* is the last node visited, *walked*
+is set when it is over), then the free nodes past the list's
+size are threaded into an ascending run [*lo*; *hi*] at the
+free list's tail (*tail*). *budget* is the number of steps made
+by every mutating call (0 - compaction is only made by explicit
+list_compact_step () calls). *fprev* is NULL when no compaction
+is in progress
+*/
+
+struct compact_t {
+
+    idx_t *fprev;
+    ssize_t walk;
+    bool walked;
+    ssize_t tail;
+    ssize_t lo;
+    ssize_t hi;
+    ssize_t budget;
 };
 
+/*
+Allocator of the nodes' storage (the node array, the SoA arrays or
+the chunks and their directory). *alloc* returns zeroed memory,
+*grow* works like realloc () (it may shrink the buffer as well,
+keeping the smaller of the two sizes), both return NULL on failure,
+leaving the old buffer as it was. Every call gets the size of the
+buffer (so that *free* may munmap () it) and *ctx*. All three NULL
+stand for calloc (), realloc () and free ()
+*/
+
+struct list_alloc_t {
+
+    void *(*alloc) (size_t size, void *ctx);
+    void *(*grow) (void *buf, size_t old_size, size_t new_size, void *ctx);
+    void (*free) (void *buf, size_t size, void *ctx);
+    void *ctx;
+};
+
+/*
+Growth policy (see list_growth ())
+*/
+
+struct growth_t {
+
+    double factor;
+    ssize_t step;
+    ssize_t max_step;
+};
+
+/*
+*untouched* is the first position that has never been used: the
+nodes from *untouched* to *cap* are free, but construction and growth
+don't write them. They are the tail of the free list, linked in
+ascending order without being stored (each one to the next position,
+the one on *cap* to FICT): free_pop () hands them out one by one,
+and the few functions that go over the free nodes by positions write
+them out first. There are none in the ring mode.
+
+*lin* is the length of the linearized prefix: nodes with
+logical numbers from 1 to *lin* are stored on positions
+from 1 to *lin*, so they're taken in O(1) even out of the quick mode.
+*ver_level* is the automatic verification level of the list.
+
+*ring_head* is FICT unless the list is in the ring mode: the quick
+mode shifted along the array. The head is on position *ring_head*,
+the node with logical number nseq is on position ring_head + nseq - 1
+(wrapping around from *cap* to 1), and the free list goes through the
+rest of the positions in the same cyclic order, starting right after
+the tail. Deleting the head of a list in the quick mode switches it
+to the ring mode, and so does inserting to the front (when there is
+a free node). Insertions and deletions at both ends keep the mode
+(it turns back into the quick mode when the head gets to position 1),
+any other insertion or deletion ends it, and so does growth. The only
+exception is growth on insertion to the front or to the back, which
+sorts the list first (see list_sort ()), so it ends up in the quick mode.
+
+*reversed* is set when the list's direction is flipped (see
+list_reverse ()): the nodes stay linked as they were, and it's
+the functions that read the links the other way round.
+
+*retire* (with its argument *retire_ctx*) is NULL unless set
+with list_retire_hook ().
+
+*alloc* is the storage's allocator (see list_ctor_alloc ()).
+
+*map* is NULL unless the nodes are stored in a file (see
+list_ctor_mapped ()): then it's the file's header mapped along
+with the nodes, and *map_fd* is the file's descriptor.
+
+*hash* is the value index (NULL unless turned on with
+list_hash_on ()): an open addressing hash table of *hash_cap*
+slots (a power of two, at least twice the capacity) holding
+positions of the live nodes, hashed by their elements. FICT
+marks an empty slot
+*/
+
+struct map_header_t;
+
 struct list_t {
 
+#if defined (LIST_SEGMENTED_STORAGE)
+    chunk_t **chunks;
+    ssize_t n_chunks;
+    ssize_t dir_cap;
+#elif defined (LIST_SOA_STORAGE)
+    elem_t *elem;
+    idx_t *next;
+    idx_t *prev;
+#else
     node_t *data;
+#endif
     ssize_t free;
+    ssize_t untouched;
     ssize_t cap;
+    ssize_t size;
+    ssize_t shrink_ratio;
+    growth_t growth;
     bool quick_mode;
+    ord_node_t *ord;
+    ssize_t ord_root;
+    ssize_t lin;
+    compact_t cmp;
+    VER_LEVEL ver_level;
+    ssize_t ring_head;
+    bool reversed;
+    void (*retire) (void *buf, void *ctx);
+    void *retire_ctx;
+    list_alloc_t alloc;
+    idx_t *hash;
+    ssize_t hash_cap;
+    map_header_t *map;
+    int map_fd;
 };
 
+/*
+Node access: everything (the list functions themselves
+included) reaches nodes' fields only through these, so that
+the code doesn't depend on the storage layout
+*/
+
+#if defined (LIST_SOA_STORAGE) && defined (LIST_SEGMENTED_STORAGE)
+
+inline elem_t &node_elem (list_t *lst, ssize_t idx) {
+
+    return lst->chunks [idx >> LIST_CHUNK_SHIFT]->elem [idx & CHUNK_MASK];
+}
+
+inline idx_t &node_next (list_t *lst, ssize_t idx) {
+
+    return lst->chunks [idx >> LIST_CHUNK_SHIFT]->next [idx & CHUNK_MASK];
+}
+
+inline idx_t &node_prev (list_t *lst, ssize_t idx) {
+
+    return lst->chunks [idx >> LIST_CHUNK_SHIFT]->prev [idx & CHUNK_MASK];
+}
+
+#elif defined (LIST_SOA_STORAGE)
+
+inline elem_t &node_elem (list_t *lst, ssize_t idx) {
+
+    return lst->elem [idx];
+}
+
+inline idx_t &node_next (list_t *lst, ssize_t idx) {
+
+    return lst->next [idx];
+}
+
+inline idx_t &node_prev (list_t *lst, ssize_t idx) {
+
+    return lst->prev [idx];
+}
+
+#else
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+inline node_t &node_at (list_t *lst, ssize_t idx) {
+
+    return lst->chunks [idx >> LIST_CHUNK_SHIFT]->node [idx & CHUNK_MASK];
+}
+
+#else
+
+inline node_t &node_at (list_t *lst, ssize_t idx) {
+
+    return lst->data [idx];
+}
+
+#endif
+
+inline elem_t &node_elem (list_t *lst, ssize_t idx) {
+
+    return node_at (lst, idx).elem;
+}
+
+inline idx_t &node_next (list_t *lst, ssize_t idx) {
+
+    return node_at (lst, idx).next;
+}
+
+inline idx_t &node_prev (list_t *lst, ssize_t idx) {
+
+    return node_at (lst, idx).prev;
+}
+
+#endif
+
+/*
+Never used positions count as free without being read
+*/
+
+inline bool node_free (list_t *lst, ssize_t idx) {
+
+    return idx >= lst->untouched || node_prev (lst, idx) == FREE_NODE_MARKER;
+}
+
 CTOR_OPER_CODE list_ctor (list_t *lst, ssize_t cap = 8);
+
+/*
+Constructs a list whose storage is allocated, grown and freed by
+*alloc* (copied to the list) instead of the C library, e.g. from
+the caller's own arenas. LIST_HUGE_PAGES is a built-in allocator
+that maps the storage with mmap () and asks for transparent huge
+pages (2 MB) with madvise (MADV_HUGEPAGE), which cuts TLB misses
+of traversals over big lists; growth is mremap (). Segmented storage
+only gets huge pages with chunks of 2 MB and more (LIST_CHUNK_SHIFT
+of 17 and more for 24-byte nodes). The order and
+the value indexes and the other side arrays are still malloc ()ed.
+A list with its own allocator can't have a retire hook
+*/
+
+extern const list_alloc_t LIST_HUGE_PAGES;
+
+CTOR_OPER_CODE list_ctor_alloc (list_t *lst, const list_alloc_t *alloc, ssize_t cap = 8);
+
+/*
+The destructor clears the storage before freeing it, so that
+dangling pointers to the nodes show up, unless NDEBUG is defined
+(then it takes O(1) instead of O(n), apart from the allocator)
+*/
+
 void list_dtor (list_t *lst);
 
+/*
+File-backed storage (flat layout only). Nodes hold indexes, not
+pointers, so the node array can be mapped from a file as it is.
+list_ctor_mapped () creates (or truncates) the file *file_name* and
+constructs an empty list in it: a header page (format version, node
+size, capacity, head of the free list, first never used position,
+size, modes) followed by the nodes. Never used nodes aren't written,
+so the file stays sparse until the list fills it. Growth and shrinking
+resize the file and remap it. The header is brought up to date by
+list_sync () (which also flushes the file to disk) and by list_dtor ().
+
+list_open () maps a file made this way. Only the header is checked
+(O(1), so opening takes the same time for any size): the nodes are
+checked by the automatic verification of the operations that touch
+them, as usual. A file that wasn't closed with list_dtor () (the
+process crashed) is checked with list_verify () as a whole; the state
+saved by the last list_sync () is then expected. The order and the
+value indexes and compaction are off in an opened list.
+
+A mapped file is held under an exclusive flock () until list_dtor ():
+creating or opening a file another list has open (in this or another
+process) fails with CTOR_MEM_ERROR or OPEN_FILE_ERROR.
+
+Don't set a retire hook on a mapped list: remapping may move
+the nodes right away
+*/
+
+CTOR_OPER_CODE list_ctor_mapped (list_t *lst, const char *file_name, ssize_t cap = 8);
+OPEN_OPER_CODE list_open (list_t *lst, const char *file_name);
+void list_sync (list_t *lst);
+
+/*
+Snapshots for shipping a list to another process or checkpointing
+it, with any layout. list_save () streams the list through *write*
+in the order of the list: a header (format version, element size,
+size) and then just the elements, in blocks of 4096. With
+*packed* every block is compressed: elements are stored
+as the differences from the previous ones, zigzag-encoded (small
+negative differences become small numbers) and written in 7-bit
+varints, so sorted or slowly changing data takes 1-2 bytes per
+element instead of 4.
+
+list_load () constructs a list from such a stream (read through
+*read*). The elements are put to positions from 1 to *size*,
+so the list arrives in the quick mode. If anything goes wrong
+the list isn't constructed.
+
+*write* and *read* get *ctx* as their last argument and must
+write or read all *len* bytes (returning false if they can't),
+so the stream may be a file, a pipe, a socket or a memory buffer
+*/
+
+SAVE_OPER_CODE list_save (list_t *lst, bool (*write) (const void *buf, size_t len, void *ctx),
+                          void *ctx, bool packed = false);
+LOAD_OPER_CODE list_load (list_t *lst, bool (*read) (void *buf, size_t len, void *ctx), void *ctx);
+
 ssize_t list_insert_front (list_t *lst, elem_t val);
 ssize_t list_insert_back (list_t *lst, elem_t val);
 ssize_t list_insert_before (list_t *lst, elem_t val, ssize_t pos);
@@ -70,11 +493,500 @@ DEL_BK_OPER_CODE list_delete_back (list_t *lst);
 DEL_OPER_CODE list_delete (list_t *lst, ssize_t pos);
 
 VERIFICATION_CODE list_verify (list_t *lst);
-DUMP_OPER_CODE list_dump (list_t *lst, const char *file_name);
+
+/*
+Sets how much of the list every operation checks before doing
+its job (with AUTO_VERIFICATION_ON): VER_FULL - the whole list
+(list_verify (), O(n)); VER_SAMPLED - the nodes the operation
+touches plus VER_SAMPLE_SIZE random nodes; VER_LOCAL - only the
+nodes the operation touches (the node at *pos*, its neighbours,
+the fictional node and the head of the free list); VER_OFF - nothing
+*/
+
+void list_verify_level (list_t *lst, VER_LEVEL level);
+
+/*
+Draws the list's cells (in the order of the array) and their links
+to the PNG file *file_name* with Graphviz (dot). With *radius* >= 0
+only the fictional cell and the cells with positions from *pos* -
+*radius* to *pos* + *radius* are drawn, so that big lists can be
+dumped too; links leading out of this window are only written in
+the cells.
+
+The nodes are copied to a snapshot first, then the graph is written
+to a unique temporary file and rendered. list_dump () does all of it
+before returning. list_dump_async () only makes the snapshot and
+leaves the rest to a background thread (dumps are rendered one by
+one, in the order of the calls), so the list may be changed right
+away; rendering errors are reported by that thread. list_dump_wait ()
+waits until all the dumps are rendered (it is called at exit as well)
+*/
+
+DUMP_OPER_CODE list_dump (list_t *lst, const char *file_name, ssize_t pos = FICT, ssize_t radius = -1);
+DUMP_OPER_CODE list_dump_async (list_t *lst, const char *file_name, ssize_t pos = FICT, ssize_t radius = -1);
+void list_dump_wait ();
 
 SORT_OPER_CODE list_sort (list_t *lst);
+
+/*
+Despite its name, list_sort () only puts the nodes in memory
+in the order of the list. These two order the list by value.
+list_sort_by () is a stable merge sort of the links (*cmp*
+returns a negative number, 0 or a positive number like strcmp ()
+does, NULL - ascending order): nodes aren't moved, so positions
+stay valid, but the list leaves the quick mode unless it was
+already sorted. list_sort_radix () sorts in ascending order by
+the elements' bits (integer elem_t only, otherwise it falls back
+to list_sort_by ()) and writes them right to positions from 1
+to *size*, so the list ends up in the quick mode. Both restore
+the original direction of a reversed list
+*/
+
+SORT_OPER_CODE list_sort_by (list_t *lst, int (*cmp) (elem_t a, elem_t b) = NULL);
+SORT_OPER_CODE list_sort_radix (list_t *lst);
+
+/*
+Multithreaded versions of list_sort () and list_verify () for big
+lists (*threads* 0 - as many as there are cores). Both rank the
+nodes in parallel (the list is cut into sublists at sampled nodes,
+threads walk the sublists, then the sublists are put in order).
+list_sort_parallel () then scatters the elements to their places
+in fresh storage (so it needs memory for a second copy of the nodes;
+without it the list is sorted in place as list_sort () does), and
+list_verify_parallel () checks the nodes' links in parallel and
+counts the nodes in the main and the free sequences (the never
+used nodes are counted without being read or written out, see
+*untouched*). Lists smaller
+than PARALLEL_MIN_SIZE are handled by the sequential functions
+*/
+
+constexpr ssize_t PARALLEL_MIN_SIZE = 1 << 15;
+
+SORT_OPER_CODE list_sort_parallel (list_t *lst, ssize_t threads = 0);
+VERIFICATION_CODE list_verify_parallel (list_t *lst, ssize_t threads = 0);
 ssize_t list_seq_insert_before (list_t *lst, elem_t val, ssize_t nseq);
 ssize_t list_seq_insert_after (list_t *lst, elem_t val, ssize_t nseq);
 DEL_SQ_OPER_CODE list_seq_delete (list_t *lst, ssize_t nseq);
 
+/*
+Bulk operations: every one of them is verified and resizes the
+list at most once. list_ctor_from () builds a list of *n*
+elements from *vals* in the quick mode. list_insert_span_after ()
+inserts *n* elements from *vals* after the node at *pos* (pos
+FICT - to the front, pos of the tail - to the back; appending
+keeps the quick mode) and returns the position of the first of
+them. New nodes are taken from the head of the free list one
+after another, so they lie contiguously whenever the free list
+starts with an ascending run (in the quick mode, after growth
+and after sorting). list_seq_delete_range () deletes the nodes
+with logical numbers from *from* to *to* - 1; deleting a suffix
+keeps the quick mode
+*/
+
+CTOR_OPER_CODE list_ctor_from (list_t *lst, const elem_t *vals, ssize_t n);
+ssize_t list_insert_span_after (list_t *lst, const elem_t *vals, ssize_t n, ssize_t pos);
+DEL_SQ_OPER_CODE list_seq_delete_range (list_t *lst, ssize_t from, ssize_t to);
+
+/*
+list_rotate () moves the first *k* nodes (the last -*k* ones
+if *k* is negative) to the back of the list: the node with logical
+number *k* + 1 becomes the head. Nothing is moved in memory - the
+fictional node is relinked between the new tail and the new head,
+so it's O(1) once the new tail is found (with the order index on
+it's O(log n), and the index is rotated with a split and a merge).
+The list leaves the quick mode unless it is full (then it's a ring,
+see list_t). list_reverse () flips the direction of the list in O(1):
+traversal, front and back, before and after and logical numbers
+all follow the new direction; list_sort () restores the original one
+*/
+
+ROTATE_OPER_CODE list_rotate (list_t *lst, ssize_t k);
+void list_reverse (list_t *lst);
+
+/*
+Makes the node at *pos* the head of the list by relinking it in
+O(1): the node isn't freed or moved, so its position, its element
+and its entry in the value index stay as they are. The list
+leaves the quick mode unless the node is the head already
+*/
+
+MOVE_OPER_CODE list_move_front (list_t *lst, ssize_t pos);
+
+/*
+With a retire hook set, the buffers of the list's storage and of
+its order index are never freed or reallocated in place while the
+list is alive (growth copies the data to new buffers): the old
+ones are passed to *retire* (along with *ctx*), which is to free
+them once nobody is reading them (see shared_list.hpp). NULL
+restores the default (free () and realloc ()). Lists with their
+own allocators (see list_ctor_alloc ()) can't have a retire hook
+*/
+
+void list_retire_hook (list_t *lst, void (*retire) (void *buf, void *ctx), void *ctx);
+
+ORD_OPER_CODE list_ord_on (list_t *lst);
+void list_ord_off (list_t *lst);
+
+/*
+Value index: with it turned on (list_hash_on (), O(n))
+list_find () returns the position of a node holding *val*
+in O(1) on average, and every insertion and deletion keeps
+it up to date in O(1) (sorting and compaction, which move
+nodes, fix it as well). Without it list_find () scans the
+elements: in the quick and the ring modes - the array itself
+(vectorized with LIST_SOA_STORAGE, where the elements are
+contiguous), otherwise - the list in its order. Which of
+several nodes holding *val* is found is unspecified; FICT
+means there's none (OPER_ERROR_VER - verification failed).
+list_delete_value () deletes such a node.
+
+An element changed in place (through list_elem ()) is not
+rehashed: with the index on, replace the node instead
+*/
+
+HASH_OPER_CODE list_hash_on (list_t *lst);
+void list_hash_off (list_t *lst);
+
+ssize_t list_find (list_t *lst, elem_t val);
+bool list_contains (list_t *lst, elem_t val);
+DEL_VAL_OPER_CODE list_delete_value (list_t *lst, elem_t val);
+
+/*
+Compaction moves nodes, so just like with list_sort ()
+real positions taken before a compaction step may become
+outdated after it. With automatic compaction turned on
+(*budget* > 0) this concerns every mutating call, except
+for the position returned by the call itself
+*/
+
+/*
+Shrinking sorts the list (see list_sort ()) before cutting
+the free nodes off, so real positions may become outdated
+after it. With automatic shrinking turned on (*ratio* > 1)
+the list is shrunk to fit every time a deletion makes
+its size less than 1 / *ratio* of its capacity
+*/
+
+RESERVE_OPER_CODE list_reserve (list_t *lst, ssize_t cap);
+SHRINK_OPER_CODE list_shrink_to_fit (list_t *lst);
+void list_shrink_auto (list_t *lst, ssize_t ratio);
+
+COMPACT_OPER_CODE list_compact_step (list_t *lst, ssize_t budget);
+void list_compact_auto (list_t *lst, ssize_t budget);
+
+/*
+A full list grows to cap * *factor* + *step* nodes, but by
+no more than *max_step* nodes at a time (0 - no limit) and
+by at least one. By default it doubles (2, 1, 0), or grows
+by a chunk (1, CHUNK_SIZE, 0) with segmented storage. The new
+nodes aren't written (see *untouched*), so growth costs the
+same however much the list grows, apart from the allocator
+(realloc () may copy the old nodes). So does construction
+*/
+
+void list_growth (list_t *lst, double factor, ssize_t step, ssize_t max_step);
+
+/*
+Node linking helpers shared by the checked functions (lst.cpp)
+and the unchecked ones below. The rarely taken paths (growth and
+the indexes) stay out of line
+*/
+
+RESIZE_OPER_CODE list_resize_up (list_t *lst);
+void ord_link (list_t *lst, ssize_t idx);
+void ord_unlink (list_t *lst, ssize_t idx);
+void hash_link (list_t *lst, ssize_t idx);
+void hash_unlink (list_t *lst, ssize_t idx);
+
+inline ssize_t free_pop (list_t *lst) {
+
+    ssize_t idx = lst->free;
+
+    if (idx >= lst->untouched) {
+
+        lst->untouched = idx + 1;
+        lst->free = (idx < lst->cap) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+
+    } else {
+
+        lst->free = node_next (lst, idx);
+    }
+
+    if (lst->cmp.fprev) {
+
+        if (lst->free != FICT) {
+
+            lst->cmp.fprev [lst->free] = FICT;
+
+        } else {
+
+            lst->cmp.tail = FICT;
+        }
+
+        if (idx == lst->cmp.walk) {
+
+            lst->cmp.walk = FICT;
+        }
+
+        if (lst->cmp.lo <= lst->cmp.hi && idx == lst->cmp.lo) {
+
+            lst->cmp.lo += 1;
+        }
+    }
+
+    return idx;
+}
+
+inline void free_push (list_t *lst, ssize_t idx) {
+
+    node_prev (lst, idx) = FREE_NODE_MARKER;
+    node_next (lst, idx) = lst->free;
+
+    if (lst->cmp.fprev) {
+
+        lst->cmp.fprev [idx] = FICT;
+        if (lst->free != FICT) {
+
+            lst->cmp.fprev [lst->free] = idx;
+
+        } else {
+
+            lst->cmp.tail = idx;
+        }
+    }
+
+    lst->free = idx;
+}
+
+/*
+Called right after a node is linked into the list
+and right before it is unlinked from it: keep
+the linearized prefix and the indexes up to date,
+and end the ring mode unless it is the tail that changes
+*/
+
+inline void node_linked (list_t *lst, ssize_t idx) {
+
+    lst->size += 1;
+
+    if (lst->ring_head != FICT && node_next (lst, idx) != FICT) {
+
+        lst->ring_head = FICT;
+    }
+
+    if (idx == lst->lin + 1 && node_prev (lst, idx) == lst->lin) {
+
+        lst->lin = idx;
+
+    } else if (node_prev (lst, idx) < lst->lin) {
+
+        lst->lin = node_prev (lst, idx);
+    }
+
+    if (lst->ord) {
+
+        ord_link (lst, idx);
+    }
+
+    if (lst->hash) {
+
+        hash_link (lst, idx);
+    }
+}
+
+inline void node_unlinked (list_t *lst, ssize_t idx) {
+
+    lst->size -= 1;
+
+    if (lst->ring_head != FICT && node_next (lst, idx) != FICT) {
+
+        lst->ring_head = FICT;
+    }
+
+    if (idx <= lst->lin) {
+
+        lst->lin = idx - 1;
+    }
+
+    if (lst->ord) {
+
+        ord_unlink (lst, idx);
+    }
+
+    if (lst->hash) {
+
+        hash_unlink (lst, idx);
+    }
+}
+
+inline void ins_before (list_t *lst, ssize_t idx, elem_t val) {
+
+    ssize_t new_idx = free_pop (lst);
+
+    node_elem (lst, new_idx) = val;
+    node_prev (lst, new_idx) = node_prev (lst, idx);
+    node_next (lst, new_idx) = idx;
+    node_next (lst, node_prev (lst, idx)) = new_idx;
+    node_prev (lst, idx) = new_idx;
+
+    node_linked (lst, new_idx);
+}
+
+inline void ins_after (list_t *lst, ssize_t idx, elem_t val) {
+
+    ssize_t new_idx = free_pop (lst);
+
+    node_elem (lst, new_idx) = val;
+    node_prev (lst, new_idx) = idx;
+    node_next (lst, new_idx) = node_next (lst, idx);
+    node_prev (lst, node_next (lst, idx)) = new_idx;
+    node_next (lst, idx) = new_idx;
+
+    node_linked (lst, new_idx);
+}
+
+inline void del (list_t *lst, ssize_t idx) {
+
+    node_unlinked (lst, idx);
+
+    node_elem (lst, idx) = FREE_NODE_ELEM;
+    node_prev (lst, node_next (lst, idx)) = node_prev (lst, idx);
+    node_next (lst, node_prev (lst, idx)) = node_next (lst, idx);
+
+    free_push (lst, idx);
+}
+
+inline void del_head (list_t *lst) {
+
+    del (lst, node_next (lst, FICT));
+}
+
+inline void del_tail (list_t *lst) {
+
+    del (lst, node_prev (lst, FICT));
+}
+
+/*
+Unchecked fast path: no verification, no validation of the
+arguments (only assertions, gone with NDEBUG) and no messages,
+so these are fully inlined. *pos* must be a position of a live
+node (or the fictional one: inserting after it is inserting
+to the front). The only error is OPER_ERROR_MEM on a failed
+growth. Unlike the checked functions, these don't make
+automatic compaction steps and never shrink the list
+*/
+
+inline ssize_t list_next (list_t *lst, ssize_t pos) {
+
+    assert (lst && pos >= 0 && pos <= lst->cap && !node_free (lst, pos));
+
+    return lst->reversed ? node_prev (lst, pos) : node_next (lst, pos);
+}
+
+inline ssize_t list_prev (list_t *lst, ssize_t pos) {
+
+    assert (lst && pos >= 0 && pos <= lst->cap && !node_free (lst, pos));
+
+    return lst->reversed ? node_next (lst, pos) : node_prev (lst, pos);
+}
+
+inline ssize_t list_head (list_t *lst) {
+
+    assert (lst);
+
+    return list_next (lst, FICT);
+}
+
+inline ssize_t list_tail (list_t *lst) {
+
+    assert (lst);
+
+    return list_prev (lst, FICT);
+}
+
+inline elem_t &list_elem (list_t *lst, ssize_t pos) {
+
+    assert (lst && pos > FICT && pos <= lst->cap && !node_free (lst, pos));
+
+    return node_elem (lst, pos);
+}
+
+inline ssize_t ins_after_unchecked (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst && pos >= 0 && pos <= lst->cap && !node_free (lst, pos));
+
+    if (lst->free == FICT && list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    if (pos != node_prev (lst, FICT)) {
+
+        lst->quick_mode = false;
+    }
+
+    ins_after (lst, pos, val);
+    return node_next (lst, pos);
+}
+
+inline ssize_t ins_before_unchecked (list_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst && pos >= 0 && pos <= lst->cap && !node_free (lst, pos));
+
+    if (lst->free == FICT && list_resize_up (lst) == RSZ_MEM_ERROR) {
+
+        return OPER_ERROR_MEM;
+    }
+
+    if (pos != FICT) {
+
+        lst->quick_mode = false;
+    }
+
+    ins_before (lst, pos, val);
+    return node_prev (lst, pos);
+}
+
+inline ssize_t list_insert_after_unchecked (list_t *lst, elem_t val, ssize_t pos) {
+
+    return lst->reversed ? ins_before_unchecked (lst, val, pos) : ins_after_unchecked (lst, val, pos);
+}
+
+inline ssize_t list_insert_before_unchecked (list_t *lst, elem_t val, ssize_t pos) {
+
+    return lst->reversed ? ins_after_unchecked (lst, val, pos) : ins_before_unchecked (lst, val, pos);
+}
+
+inline ssize_t list_insert_front_unchecked (list_t *lst, elem_t val) {
+
+    return list_insert_after_unchecked (lst, val, FICT);
+}
+
+inline ssize_t list_insert_back_unchecked (list_t *lst, elem_t val) {
+
+    return list_insert_before_unchecked (lst, val, FICT);
+}
+
+inline void list_delete_unchecked (list_t *lst, ssize_t pos) {
+
+    assert (lst && pos > FICT && pos <= lst->cap && !node_free (lst, pos));
+
+    if (pos != node_prev (lst, FICT)) {
+
+        lst->quick_mode = false;
+    }
+
+    del (lst, pos);
+}
+
+inline void list_delete_front_unchecked (list_t *lst) {
+
+    list_delete_unchecked (lst, list_head (lst));
+}
+
+inline void list_delete_back_unchecked (list_t *lst) {
+
+    list_delete_unchecked (lst, list_tail (lst));
+}
+
 #endif
@@ -0,0 +1,630 @@
+#include "pool.hpp"
+
+static bool pool_resize_up (pool_t *pool);
+static ssize_t pool_pop (pool_t *pool);
+static void pool_push (pool_t *pool, ssize_t idx);
+static bool node_live (pool_t *pool, ssize_t idx);
+static VERIFICATION_CODE plist_auto_verify (plist_t *lst, ssize_t pos);
+static VERIFICATION_CODE pool_verify_node (pool_t *pool, ssize_t idx);
+static ssize_t ins_before (pool_t *pool, ssize_t idx, elem_t val);
+static void splice (pool_t *pool, ssize_t pos, ssize_t first, ssize_t last);
+
+CTOR_OPER_CODE pool_ctor (pool_t *pool, ssize_t cap /* = 8 */) {
+
+    assert (pool);
+
+    if (cap > MAX_CAP) {
+
+        printf ("\nConstruction failed: capacity %lld exceeds the maximum capacity %lld\n", cap, MAX_CAP);
+        return CTOR_MEM_ERROR;
+    }
+
+    pool->data = (node_t *) calloc (cap + 1, sizeof (node_t));
+    if (pool->data == NULL) {
+
+        printf ("\nConstruction failed: memory error\n");
+        return CTOR_MEM_ERROR;
+    }
+
+    node_elem (pool, FICT) = FICT_NODE_ELEM;
+    node_next (pool, FICT) = FICT;
+    node_prev (pool, FICT) = FICT;
+
+    for (ssize_t idx = 1; idx <= cap; ++ idx) {
+
+        node_elem (pool, idx) = FREE_NODE_ELEM;
+        node_prev (pool, idx) = FREE_NODE_MARKER;
+        node_next (pool, idx) = (idx < cap) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+    }
+
+    pool->free = (cap != 0) ? 1 : FICT;
+    pool->cap = cap;
+    pool->ver_level = LIST_VER_LEVEL;
+
+    return CONSTRUCTED;
+}
+
+void pool_dtor (pool_t *pool) {
+
+    assert (pool);
+
+    free (pool->data);
+    pool->data = (node_t *) OS_RESERVED_ADDR;
+
+    pool->cap = -1;
+    pool->free = -1;
+}
+
+void pool_verify_level (pool_t *pool, VER_LEVEL level) {
+
+    assert (pool);
+
+    pool->ver_level = level;
+}
+
+CTOR_OPER_CODE plist_ctor (plist_t *lst, pool_t *pool) {
+
+    assert (lst);
+    assert (pool);
+
+    if (pool->free == FICT && !pool_resize_up (pool)) {
+
+        printf ("\nConstruction failed: memory error while trying to resize the pool up \
+                from capacity %lld\n", pool->cap);
+        return CTOR_MEM_ERROR;
+    }
+
+    ssize_t head = pool_pop (pool);
+
+    node_elem (pool, head) = FICT_NODE_ELEM;
+    node_next (pool, head) = head;
+    node_prev (pool, head) = head;
+
+    lst->pool = pool;
+    lst->head = head;
+
+    return CONSTRUCTED;
+}
+
+/*
+Returns all the nodes of the list (its head included) to the
+pool. Unlike the other list operations, this one is O(n)
+*/
+
+void plist_dtor (plist_t *lst) {
+
+    assert (lst);
+
+    pool_t *pool = lst->pool;
+
+    ssize_t idx = node_next (pool, lst->head);
+    while (idx != lst->head) {
+
+        ssize_t next = node_next (pool, idx);
+        pool_push (pool, idx);
+        idx = next;
+    }
+    pool_push (pool, lst->head);
+
+    lst->pool = NULL;
+    lst->head = -1;
+}
+
+ssize_t plist_size (plist_t *lst) {
+
+    assert (lst);
+
+    ssize_t size = 0;
+    for (ssize_t idx = plist_first (lst); idx != lst->head; idx = plist_next (lst, idx)) {
+
+        size += 1;
+    }
+
+    return size;
+}
+
+ssize_t plist_insert_front (plist_t *lst, elem_t val) {
+
+    assert (lst);
+
+    return plist_insert_after (lst, val, lst->head);
+}
+
+ssize_t plist_insert_back (plist_t *lst, elem_t val) {
+
+    assert (lst);
+
+    return plist_insert_before (lst, val, lst->head);
+}
+
+ssize_t plist_insert_before (plist_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    pool_t *pool = lst->pool;
+
+    if (!node_live (pool, pos)) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free or nonexistent node while trying to insert \
+                an element before one on position %lld, in function plist_insert_before ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (pool->free == FICT && !pool_resize_up (pool)) {
+
+        printf ("\nResize failed: memory error while trying to resize the pool up \
+                from capacity %lld, in function plist_insert_before ()\n", pool->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    return ins_before (pool, pos, val);
+}
+
+ssize_t plist_insert_after (plist_t *lst, elem_t val, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return OPER_ERROR_VER;
+    }
+
+#endif
+
+    pool_t *pool = lst->pool;
+
+    if (!node_live (pool, pos)) {
+
+        printf ("\nInsertion failed: *pos* argument is pointing at a free or nonexistent node while trying to insert \
+                an element after one on position %lld, in function plist_insert_after ()\n",
+                pos);
+        return OPER_ERROR_INP;
+    }
+
+    if (pool->free == FICT && !pool_resize_up (pool)) {
+
+        printf ("\nResize failed: memory error while trying to resize the pool up \
+                from capacity %lld, in function plist_insert_after ()\n", pool->cap);
+        return OPER_ERROR_MEM;
+    }
+
+    return ins_before (pool, node_next (pool, pos), val);
+}
+
+DEL_FR_OPER_CODE plist_delete_front (plist_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (lst, lst->head) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_FR_VER_FAILED;
+    }
+
+#endif
+
+    if (plist_empty (lst)) {
+
+        return NO_HEAD_TO_DELETE;
+    }
+
+    ssize_t idx = plist_first (lst);
+
+    node_next (lst->pool, lst->head) = node_next (lst->pool, idx);
+    node_prev (lst->pool, node_next (lst->pool, idx)) = lst->head;
+    pool_push (lst->pool, idx);
+
+    return HEAD_DELETED;
+}
+
+DEL_BK_OPER_CODE plist_delete_back (plist_t *lst) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (lst, lst->head) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_BK_VER_FAILED;
+    }
+
+#endif
+
+    if (plist_empty (lst)) {
+
+        return NO_TAIL_TO_DELETE;
+    }
+
+    ssize_t idx = plist_last (lst);
+
+    node_prev (lst->pool, lst->head) = node_prev (lst->pool, idx);
+    node_next (lst->pool, node_prev (lst->pool, idx)) = lst->head;
+    pool_push (lst->pool, idx);
+
+    return TAIL_DELETED;
+}
+
+DEL_OPER_CODE plist_delete (plist_t *lst, ssize_t pos) {
+
+    assert (lst);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (lst, pos) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return DEL_VER_FAILED;
+    }
+
+#endif
+
+    pool_t *pool = lst->pool;
+
+    if (pos == lst->head || !node_live (pool, pos)) {
+
+        printf ("\nDeletion failed: *pos* argument is pointing at a fictional, free or nonexistent node while trying to delete \
+                an element on position %lld, in function plist_delete ()\n",
+                pos);
+        return DEL_WRONG_INPUT;
+    }
+
+    node_prev (pool, node_next (pool, pos)) = node_prev (pool, pos);
+    node_next (pool, node_prev (pool, pos)) = node_next (pool, pos);
+    pool_push (pool, pos);
+
+    return DELETED;
+}
+
+SPLICE_OPER_CODE plist_splice (plist_t *dst, ssize_t pos, plist_t *src, ssize_t first, ssize_t last) {
+
+    assert (dst);
+    assert (src);
+
+#ifdef AUTO_VERIFICATION_ON
+
+    if (plist_auto_verify (dst, pos) != NO_FLAWS || plist_auto_verify (src, first) != NO_FLAWS) {
+
+        DUMP_POSITION();
+        return SPL_VER_FAILED;
+    }
+
+#endif
+
+    pool_t *pool = dst->pool;
+
+    if (src->pool != pool) {
+
+        printf ("\nSplice failed: the lists don't share a pool, in function plist_splice ()\n");
+        return SPL_WRONG_INPUT;
+    }
+
+    if (!node_live (pool, pos) || !node_live (pool, first) || !node_live (pool, last) ||
+        first == src->head || last == src->head) {
+
+        printf ("\nSplice failed: one of the positions (pos %lld, first %lld, last %lld) is pointing at \
+                a fictional, free or nonexistent node, in function plist_splice ()\n",
+                pos, first, last);
+        return SPL_WRONG_INPUT;
+    }
+
+#ifdef AUTO_VERIFICATION_ON
+
+    /*
+    The only O(n) check: that the chain really goes from *first*
+    to *last* in *src* and doesn't contain *pos*
+    */
+
+    if (pool->ver_level == VER_FULL) {
+
+        ssize_t idx = first;
+        for ( ; idx != last && idx != src->head && idx != pos; idx = node_next (pool, idx)) ;
+
+        if (idx != last || pos == last) {
+
+            printf ("\nSplice failed: nodes from %lld to %lld don't form a chain of the source list \
+                    or the chain contains position %lld, in function plist_splice ()\n",
+                    first, last, pos);
+            return SPL_WRONG_INPUT;
+        }
+    }
+
+#endif
+
+    splice (pool, pos, first, last);
+
+    return SPLICED;
+}
+
+SPLICE_OPER_CODE plist_split (plist_t *lst, ssize_t pos, plist_t *out) {
+
+    assert (lst);
+    assert (out);
+
+    if (lst == out) {
+
+        printf ("\nSplit failed: the source and the destination are the same list, in function plist_split ()\n");
+        return SPL_WRONG_INPUT;
+    }
+
+    return plist_splice (out, plist_last (out), lst, pos, plist_last (lst));
+}
+
+SPLICE_OPER_CODE plist_concat (plist_t *dst, plist_t *src) {
+
+    assert (dst);
+    assert (src);
+
+    if (dst == src) {
+
+        printf ("\nConcatenation failed: a list can't be concatenated with itself, in function plist_concat ()\n");
+        return SPL_WRONG_INPUT;
+    }
+
+    if (plist_empty (src)) {
+
+        return SPLICED;
+    }
+
+    return plist_splice (dst, plist_last (dst), src, plist_first (src), plist_last (src));
+}
+
+VERIFICATION_CODE pool_verify (pool_t *pool) {
+
+    assert (pool);
+
+    if (pool->data == NULL) {
+
+        printf ("\nVerification failed: pool's *data* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+    if (pool->cap < 0) {
+
+        printf ("\nVerification failed: pool's *capacity* parameter ran below zero (%lld)\n", pool->cap);
+        return CAP_FLAW;
+    }
+
+    ssize_t nodes_handled = 0, idx = pool->free;
+    for ( ; idx != FICT && nodes_handled < pool->cap; ++ nodes_handled, idx = node_next (pool, idx)) {
+
+        if (idx < 0 || idx > pool->cap) {
+
+            printf ("\nVerification failed: the pool's free list contains \
+                    an impossible index: %lld\n", idx);
+            return FREE_IDX_FLAW;
+        }
+
+        if (node_prev (pool, idx) != FREE_NODE_MARKER) {
+
+            printf ("\nVerification failed: the free node on position %lld has \
+                    no *free node* marker (prev: %lld)\n",
+                    idx, (ssize_t) node_prev (pool, idx));
+            return FREE_MARKER_FLAW;
+        }
+    }
+
+    if (idx != FICT) {
+
+        printf ("\nVerification failed: the pool's free list is looped\n");
+        return FREE_IDX_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+VERIFICATION_CODE plist_verify (plist_t *lst) {
+
+    assert (lst);
+
+    if (lst->pool == NULL) {
+
+        printf ("\nVerification failed: list's *pool* pointer is NULL\n");
+        return DATA_FLAW;
+    }
+
+    VERIFICATION_CODE code = pool_verify (lst->pool);
+    if (code != NO_FLAWS) {
+
+        return code;
+    }
+
+    pool_t *pool = lst->pool;
+
+    if (!node_live (pool, lst->head)) {
+
+        printf ("\nVerification failed: list's fictional node (%lld) \
+                is free or nonexistent\n", lst->head);
+        return FICT_FLAW;
+    }
+
+    ssize_t nodes_handled = 0, idx = lst->head;
+    do {
+
+        code = pool_verify_node (pool, idx);
+        if (code != NO_FLAWS) {
+
+            return code;
+        }
+
+        idx = node_next (pool, idx);
+        nodes_handled += 1;
+
+    } while (idx != lst->head && nodes_handled <= pool->cap);
+
+    if (idx != lst->head) {
+
+        printf ("\nVerification failed: list's sequence is looped \
+                not through its fictional node (%lld)\n", lst->head);
+        return INCOMPLETENESS_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+static VERIFICATION_CODE plist_auto_verify (plist_t *lst, ssize_t pos) {
+
+    pool_t *pool = lst->pool;
+
+    if (pool->ver_level == VER_OFF) {
+
+        return NO_FLAWS;
+    }
+
+    if (pool->ver_level == VER_FULL) {
+
+        return plist_verify (lst);
+    }
+
+    if (pool->free < 0 || pool->free > pool->cap ||
+        (pool->free != FICT && node_prev (pool, pool->free) != FREE_NODE_MARKER)) {
+
+        printf ("\nVerification failed: pool's *free* index (%lld) is out of range \
+                or is pointing at a node without the *free node* marker\n", pool->free);
+        return FREE_FLAW;
+    }
+
+    if (!node_live (pool, lst->head)) {
+
+        printf ("\nVerification failed: list's fictional node (%lld) \
+                is free or nonexistent\n", lst->head);
+        return FICT_FLAW;
+    }
+
+    VERIFICATION_CODE code = pool_verify_node (pool, lst->head);
+
+    if (code == NO_FLAWS && pos != lst->head && node_live (pool, pos)) {
+
+        code = pool_verify_node (pool, pos);
+    }
+
+    return code;
+}
+
+static VERIFICATION_CODE pool_verify_node (pool_t *pool, ssize_t idx) {
+
+    ssize_t next = node_next (pool, idx), prev = node_prev (pool, idx);
+
+    if (!node_live (pool, next) || !node_live (pool, prev)) {
+
+        printf ("\nVerification failed: the node on position %lld has \
+                a free or impossible neighbour (next: %lld, prev: %lld)\n",
+                idx, next, prev);
+        return LST_IDX_FLAW;
+    }
+
+    if (node_prev (pool, next) != idx || node_next (pool, prev) != idx) {
+
+        printf ("\nVerification failed: incongruity of next and prev parameters \
+                detected around the node on position %lld (next: %lld, prev: %lld)\n",
+                idx, next, prev);
+        return LST_SEQUENCE_FLAW;
+    }
+
+    return NO_FLAWS;
+}
+
+static bool node_live (pool_t *pool, ssize_t idx) {
+
+    return idx > FICT && idx <= pool->cap && node_prev (pool, idx) != FREE_NODE_MARKER;
+}
+
+static ssize_t ins_before (pool_t *pool, ssize_t idx, elem_t val) {
+
+    ssize_t new_idx = pool_pop (pool);
+
+    node_elem (pool, new_idx) = val;
+    node_prev (pool, new_idx) = node_prev (pool, idx);
+    node_next (pool, new_idx) = idx;
+    node_next (pool, node_prev (pool, idx)) = new_idx;
+    node_prev (pool, idx) = new_idx;
+
+    return new_idx;
+}
+
+/*
+Unlinks the chain from *first* to *last* from wherever
+it is and links it back after the node at *pos*
+*/
+
+static void splice (pool_t *pool, ssize_t pos, ssize_t first, ssize_t last) {
+
+    ssize_t before = node_prev (pool, first), after = node_next (pool, last);
+
+    node_next (pool, before) = after;
+    node_prev (pool, after) = before;
+
+    ssize_t pos_next = node_next (pool, pos);
+
+    node_next (pool, pos) = first;
+    node_prev (pool, first) = pos;
+    node_next (pool, last) = pos_next;
+    node_prev (pool, pos_next) = last;
+}
+
+static ssize_t pool_pop (pool_t *pool) {
+
+    ssize_t idx = pool->free;
+    pool->free = node_next (pool, idx);
+
+    return idx;
+}
+
+static void pool_push (pool_t *pool, ssize_t idx) {
+
+    node_elem (pool, idx) = FREE_NODE_ELEM;
+    node_prev (pool, idx) = FREE_NODE_MARKER;
+    node_next (pool, idx) = pool->free;
+
+    pool->free = idx;
+}
+
+/*
+Grows the pool (only called when there are no free nodes);
+nodes don't change their positions, so the lists stay valid
+*/
+
+static bool pool_resize_up (pool_t *pool) {
+
+    ssize_t old_cap = pool->cap, new_cap = pool->cap * 2 + 1;
+    if (new_cap > MAX_CAP) {
+
+        return false;
+    }
+
+    node_t *buffer = (node_t *) realloc (pool->data, (new_cap + 1) * sizeof (node_t));
+    if (buffer == NULL) {
+
+        return false;
+    }
+
+    pool->data = buffer;
+    pool->cap = new_cap;
+
+    for (ssize_t idx = old_cap + 1; idx <= new_cap; ++ idx) {
+
+        node_elem (pool, idx) = FREE_NODE_ELEM;
+        node_prev (pool, idx) = FREE_NODE_MARKER;
+        node_next (pool, idx) = (idx < new_cap) ? (ssize_t) (idx + 1) : (ssize_t) FICT;
+    }
+
+    pool->free = old_cap + 1;
+
+    return true;
+}
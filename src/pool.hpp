@@ -0,0 +1,123 @@
+#ifndef POOL_ACTIVE
+#define POOL_ACTIVE
+
+#include "lst.hpp"
+
+/*
+Shared node pool: several lists (plist_t) take their nodes
+from one array and one free list. Every list has its own
+fictional node (*head*) allocated from the pool, so the
+lists' nodes can be moved from one list to another with
+O(1) relinks: splicing a chain of nodes, splitting a list
+at a node and concatenating two lists don't copy anything.
+
+Node 0 of the pool is never used (FICT terminates the free
+list), list heads are ordinary nodes with FICT_NODE_ELEM
+as an element. The pool always uses a single node_t array,
+whatever the storage options of list_t are. Positions stay
+valid when the pool grows.
+
+The lists don't keep their sizes (that would make splicing
+O(n)), and they don't have the quick mode or the order index.
+With AUTO_VERIFICATION_ON the pool's *ver_level* (set with
+pool_verify_level ()) is used: VER_FULL verifies the whole
+lists involved, VER_LOCAL and VER_SAMPLED only check the nodes
+the operation touches
+*/
+
+struct pool_t {
+
+    node_t *data;
+    ssize_t free;
+    ssize_t cap;
+    VER_LEVEL ver_level;
+};
+
+struct plist_t {
+
+    pool_t *pool;
+    ssize_t head;
+};
+
+inline elem_t &node_elem (pool_t *pool, ssize_t idx) {
+
+    return pool->data [idx].elem;
+}
+
+inline idx_t &node_next (pool_t *pool, ssize_t idx) {
+
+    return pool->data [idx].next;
+}
+
+inline idx_t &node_prev (pool_t *pool, ssize_t idx) {
+
+    return pool->data [idx].prev;
+}
+
+/*
+Traversal: nodes of *lst* go from plist_first () to
+plist_last (); plist_next () of the last one is *lst->head*
+*/
+
+inline ssize_t plist_first (plist_t *lst) {
+
+    return node_next (lst->pool, lst->head);
+}
+
+inline ssize_t plist_last (plist_t *lst) {
+
+    return node_prev (lst->pool, lst->head);
+}
+
+inline ssize_t plist_next (plist_t *lst, ssize_t pos) {
+
+    return node_next (lst->pool, pos);
+}
+
+inline ssize_t plist_prev (plist_t *lst, ssize_t pos) {
+
+    return node_prev (lst->pool, pos);
+}
+
+inline bool plist_empty (plist_t *lst) {
+
+    return node_next (lst->pool, lst->head) == lst->head;
+}
+
+CTOR_OPER_CODE pool_ctor (pool_t *pool, ssize_t cap = 8);
+void pool_dtor (pool_t *pool);
+VERIFICATION_CODE pool_verify (pool_t *pool);
+void pool_verify_level (pool_t *pool, VER_LEVEL level);
+
+CTOR_OPER_CODE plist_ctor (plist_t *lst, pool_t *pool);
+void plist_dtor (plist_t *lst);
+VERIFICATION_CODE plist_verify (plist_t *lst);
+ssize_t plist_size (plist_t *lst);
+
+ssize_t plist_insert_front (plist_t *lst, elem_t val);
+ssize_t plist_insert_back (plist_t *lst, elem_t val);
+ssize_t plist_insert_before (plist_t *lst, elem_t val, ssize_t pos);
+ssize_t plist_insert_after (plist_t *lst, elem_t val, ssize_t pos);
+
+DEL_FR_OPER_CODE plist_delete_front (plist_t *lst);
+DEL_BK_OPER_CODE plist_delete_back (plist_t *lst);
+DEL_OPER_CODE plist_delete (plist_t *lst, ssize_t pos);
+
+/*
+plist_splice () moves the chain of nodes from *first* to *last*
+(in the order of *src*, both included) from *src* to *dst*,
+after the node at *pos* (pos *dst->head* - to the front).
+*src* and *dst* may be the same list, but then *pos* must not
+be inside the chain. plist_split () moves the nodes from *pos*
+to the tail of *lst* to the back of *out*; plist_concat () moves
+all the nodes of *src* to the back of *dst*. All of them are O(1)
+(without full verification); the lists must share the pool
+*/
+
+enum SPLICE_OPER_CODE {SPLICED = 0, SPL_VER_FAILED = 2, SPL_WRONG_INPUT = 3};
+
+SPLICE_OPER_CODE plist_splice (plist_t *dst, ssize_t pos, plist_t *src, ssize_t first, ssize_t last);
+SPLICE_OPER_CODE plist_split (plist_t *lst, ssize_t pos, plist_t *out);
+SPLICE_OPER_CODE plist_concat (plist_t *dst, plist_t *src);
+
+#endif
@@ -0,0 +1,569 @@
+#include <thread>
+
+#include "shared_list.hpp"
+
+struct read_args_t {
+
+    ssize_t nseq;
+    elem_t *vals;
+    ssize_t n;
+};
+
+typedef ssize_t (*read_func_t) (list_t *hdr, read_args_t *args);
+
+static ssize_t shared_read (shlist_t *sh, read_func_t read, read_args_t *args);
+static bool snapshot (shlist_t *sh, list_t *hdr, uint64_t *seq);
+static bool validate (shlist_t *sh, uint64_t seq);
+static ssize_t reader_enter (shlist_t *sh);
+static void reader_exit (shlist_t *sh, ssize_t handle);
+static bool readers_gone (shlist_t *sh, ssize_t parity);
+static void retire (void *buf, void *ctx);
+static void reclaim (shlist_t *sh);
+static void synchronize (shlist_t *sh);
+static void batch_free (sh_retired_t *batch);
+static void copy_header (list_t *hdr, list_t *lst);
+static elem_t snap_elem (list_t *hdr, ssize_t idx);
+static idx_t snap_next (list_t *hdr, ssize_t idx);
+static idx_t snap_prev (list_t *hdr, ssize_t idx);
+static ssize_t snap_node (list_t *hdr, ssize_t nseq);
+static ssize_t read_size (list_t *hdr, read_args_t *args);
+static ssize_t read_take (list_t *hdr, read_args_t *args);
+static ssize_t read_span (list_t *hdr, read_args_t *args);
+
+constexpr ssize_t READ_TORN = -4;           // The snapshot turned out inconsistent
+
+static std::atomic<ssize_t> stripes_given {0};
+static thread_local ssize_t stripe = -1;
+
+CTOR_OPER_CODE shlist_ctor (shlist_t *sh, ssize_t cap /* = 8 */) {
+
+    assert (sh);
+
+    if (list_ctor (&sh->lst, cap) != CONSTRUCTED) {
+
+        return CTOR_MEM_ERROR;
+    }
+
+    list_retire_hook (&sh->lst, retire, sh);
+
+    sh->seq.store (0);
+    sh->epoch.store (0);
+
+    for (ssize_t i = 0; i < SH_STRIPES; ++ i) {
+
+        sh->readers [i].active [0].store (0);
+        sh->readers [i].active [1].store (0);
+    }
+
+    sh->retired = NULL;
+    sh->grace = NULL;
+
+    return CONSTRUCTED;
+}
+
+/*
+No thread may be using the list by now, so the
+retired buffers are freed without waiting
+*/
+
+void shlist_dtor (shlist_t *sh) {
+
+    assert (sh);
+
+    list_dtor (&sh->lst);
+
+    batch_free (sh->retired);
+    batch_free (sh->grace);
+    sh->retired = NULL;
+    sh->grace = NULL;
+}
+
+list_t *shlist_write_begin (shlist_t *sh) {
+
+    assert (sh);
+
+    sh->lock.lock ();
+
+    sh->seq.store (sh->seq.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    return &sh->lst;
+}
+
+void shlist_write_end (shlist_t *sh) {
+
+    assert (sh);
+
+    sh->seq.store (sh->seq.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    reclaim (sh);
+    sh->lock.unlock ();
+}
+
+ssize_t shlist_insert_front (shlist_t *sh, elem_t val) {
+
+    ssize_t pos = list_insert_front (shlist_write_begin (sh), val);
+    shlist_write_end (sh);
+
+    return pos;
+}
+
+ssize_t shlist_insert_back (shlist_t *sh, elem_t val) {
+
+    ssize_t pos = list_insert_back (shlist_write_begin (sh), val);
+    shlist_write_end (sh);
+
+    return pos;
+}
+
+ssize_t shlist_seq_insert_after (shlist_t *sh, elem_t val, ssize_t nseq) {
+
+    ssize_t pos = list_seq_insert_after (shlist_write_begin (sh), val, nseq);
+    shlist_write_end (sh);
+
+    return pos;
+}
+
+DEL_SQ_OPER_CODE shlist_seq_delete (shlist_t *sh, ssize_t nseq) {
+
+    DEL_SQ_OPER_CODE code = list_seq_delete (shlist_write_begin (sh), nseq);
+    shlist_write_end (sh);
+
+    return code;
+}
+
+ssize_t shlist_size (shlist_t *sh) {
+
+    assert (sh);
+
+    read_args_t args = {};
+    return shared_read (sh, read_size, &args);
+}
+
+ssize_t shlist_take (shlist_t *sh, ssize_t nseq, elem_t *val) {
+
+    assert (sh);
+    assert (val);
+
+    read_args_t args = {nseq, val, 1};
+    return shared_read (sh, read_take, &args);
+}
+
+ssize_t shlist_read (shlist_t *sh, ssize_t nseq, elem_t *vals, ssize_t n) {
+
+    assert (sh);
+    assert (vals || n == 0);
+
+    read_args_t args = {nseq, vals, n};
+    return shared_read (sh, read_span, &args);
+}
+
+/*
+Optimistic attempts first, then the same read under the
+writers' mutex (the list is consistent there, so *read*
+can't come across a torn state)
+*/
+
+static ssize_t shared_read (shlist_t *sh, read_func_t read, read_args_t *args) {
+
+    ssize_t handle = reader_enter (sh);
+
+    for (ssize_t tries = 0; tries < SH_READ_TRIES; ++ tries) {
+
+        list_t hdr = {};
+        uint64_t seq = 0;
+
+        if (!snapshot (sh, &hdr, &seq)) {
+
+            std::this_thread::yield ();
+            continue;
+        }
+
+        ssize_t res = read (&hdr, args);
+        if (res != READ_TORN && validate (sh, seq)) {
+
+            reader_exit (sh, handle);
+            return res;
+        }
+    }
+
+    reader_exit (sh, handle);
+
+    std::lock_guard<std::mutex> guard (sh->lock);
+    return read (&sh->lst, args);
+}
+
+/*
+The copy of the header is only used if no writer touched
+the list while it was being made: then its buffers are
+the current ones, and they can't be freed until the reader
+leaves its epoch
+*/
+
+static bool snapshot (shlist_t *sh, list_t *hdr, uint64_t *seq) {
+
+    *seq = sh->seq.load (std::memory_order_acquire);
+    if (*seq & 1) {
+
+        return false;
+    }
+
+    copy_header (hdr, &sh->lst);
+
+    return validate (sh, *seq);
+}
+
+/*
+Readers run alongside the writer, so every word they read
+from the list is an atomic (relaxed) load: the fields of list_t
+the read functions use, the chunk directory, the nodes' links
+and elements and the order index. Whether the words add up
+to a consistent state is up to the checks of *seq*. The writer's
+stores are plain, so these are the reads tsan.supp names
+*/
+
+template <typename V>
+static V load_relaxed (const V *var) {
+
+    return __atomic_load_n (var, __ATOMIC_RELAXED);
+}
+
+static void copy_header (list_t *hdr, list_t *lst) {
+
+#if defined (LIST_SEGMENTED_STORAGE)
+    hdr->chunks = load_relaxed (&lst->chunks);
+#elif defined (LIST_SOA_STORAGE)
+    hdr->elem = load_relaxed (&lst->elem);
+    hdr->next = load_relaxed (&lst->next);
+    hdr->prev = load_relaxed (&lst->prev);
+#else
+    hdr->data = load_relaxed (&lst->data);
+#endif
+
+    hdr->cap = load_relaxed (&lst->cap);
+    hdr->size = load_relaxed (&lst->size);
+    hdr->lin = load_relaxed (&lst->lin);
+    hdr->quick_mode = load_relaxed (&lst->quick_mode);
+    hdr->reversed = load_relaxed (&lst->reversed);
+    hdr->ring_head = load_relaxed (&lst->ring_head);
+    hdr->ord = load_relaxed (&lst->ord);
+    hdr->ord_root = load_relaxed (&lst->ord_root);
+}
+
+#ifdef LIST_SEGMENTED_STORAGE
+
+static chunk_t *snap_chunk (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&hdr->chunks [idx >> LIST_CHUNK_SHIFT]);
+}
+
+#endif
+
+#if defined (LIST_SOA_STORAGE) && defined (LIST_SEGMENTED_STORAGE)
+
+static elem_t snap_elem (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->elem [idx & CHUNK_MASK]);
+}
+
+static idx_t snap_next (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->next [idx & CHUNK_MASK]);
+}
+
+static idx_t snap_prev (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->prev [idx & CHUNK_MASK]);
+}
+
+#elif defined (LIST_SEGMENTED_STORAGE)
+
+static elem_t snap_elem (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->node [idx & CHUNK_MASK].elem);
+}
+
+static idx_t snap_next (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->node [idx & CHUNK_MASK].next);
+}
+
+static idx_t snap_prev (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&snap_chunk (hdr, idx)->node [idx & CHUNK_MASK].prev);
+}
+
+#else
+
+static elem_t snap_elem (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&node_elem (hdr, idx));
+}
+
+static idx_t snap_next (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&node_next (hdr, idx));
+}
+
+static idx_t snap_prev (list_t *hdr, ssize_t idx) {
+
+    return load_relaxed (&node_prev (hdr, idx));
+}
+
+#endif
+
+static bool validate (shlist_t *sh, uint64_t seq) {
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+
+    return sh->seq.load (std::memory_order_relaxed) == seq;
+}
+
+static ssize_t reader_enter (shlist_t *sh) {
+
+    if (stripe == -1) {
+
+        stripe = stripes_given.fetch_add (1) % SH_STRIPES;
+    }
+
+    for (;;) {
+
+        uint64_t epoch = sh->epoch.load ();
+        sh->readers [stripe].active [epoch & 1].fetch_add (1);
+
+        if (sh->epoch.load () == epoch) {
+
+            return stripe * 2 + (ssize_t) (epoch & 1);
+        }
+
+        sh->readers [stripe].active [epoch & 1].fetch_sub (1);
+    }
+}
+
+static void reader_exit (shlist_t *sh, ssize_t handle) {
+
+    sh->readers [handle / 2].active [handle % 2].fetch_sub (1, std::memory_order_release);
+}
+
+static bool readers_gone (shlist_t *sh, ssize_t parity) {
+
+    for (ssize_t i = 0; i < SH_STRIPES; ++ i) {
+
+        if (sh->readers [i].active [parity].load () != 0) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+Called by the list (under the writers' mutex) instead of
+freeing a buffer. Without memory for the record it waits
+for a whole grace period right away
+*/
+
+static void retire (void *buf, void *ctx) {
+
+    shlist_t *sh = (shlist_t *) ctx;
+
+    sh_retired_t *rec = (sh_retired_t *) malloc (sizeof (sh_retired_t));
+    if (rec == NULL) {
+
+        synchronize (sh);
+        free (buf);
+        return;
+    }
+
+    rec->buf = buf;
+    rec->next = sh->retired;
+    sh->retired = rec;
+}
+
+/*
+Never waits: the previous batch is freed if the readers of
+the previous epoch are gone, and a new batch is only started
+(with an epoch switch) when there's no previous one
+*/
+
+static void reclaim (shlist_t *sh) {
+
+    uint64_t epoch = sh->epoch.load ();
+
+    if (sh->grace && readers_gone (sh, (epoch - 1) & 1)) {
+
+        batch_free (sh->grace);
+        sh->grace = NULL;
+    }
+
+    if (sh->grace == NULL && sh->retired) {
+
+        sh->grace = sh->retired;
+        sh->retired = NULL;
+
+        sh->epoch.fetch_add (1);
+    }
+}
+
+/*
+Two epoch switches, each waiting for the readers of the
+epoch left: every reader that could see the buffers retired
+so far is gone after that
+*/
+
+static void synchronize (shlist_t *sh) {
+
+    for (ssize_t i = 0; i < 2; ++ i) {
+
+        uint64_t epoch = sh->epoch.fetch_add (1);
+        while (!readers_gone (sh, epoch & 1)) {
+
+            std::this_thread::yield ();
+        }
+    }
+
+    batch_free (sh->grace);
+    batch_free (sh->retired);
+    sh->grace = NULL;
+    sh->retired = NULL;
+}
+
+static void batch_free (sh_retired_t *batch) {
+
+    while (batch) {
+
+        sh_retired_t *next = batch->next;
+        free (batch->buf);
+        free (batch);
+        batch = next;
+    }
+}
+
+/*
+Position of the node with logical number *nseq* (in [1; size])
+in the list described by *hdr*, found like list_take () does,
+but never making more steps than there are nodes and never
+leaving the storage (READ_TORN if it would have to)
+*/
+
+static ssize_t snap_node (list_t *hdr, ssize_t nseq) {
+
+    if (hdr->reversed) {
+
+        nseq = hdr->size + 1 - nseq;
+    }
+
+    if (hdr->quick_mode || nseq <= hdr->lin) {
+
+        return nseq;
+    }
+
+    if (hdr->ring_head != FICT) {
+
+        ssize_t idx = hdr->ring_head + nseq - 1;
+        return (idx > hdr->cap) ? idx - hdr->cap : idx;
+    }
+
+    if (hdr->ord) {
+
+        ord_node_t *ord = hdr->ord;
+
+        ssize_t idx = hdr->ord_root;
+        for (ssize_t steps = 0; steps <= hdr->cap; ++ steps) {
+
+            if (idx <= FICT || idx > hdr->cap) {
+
+                return READ_TORN;
+            }
+
+            ssize_t left_idx = load_relaxed (&ord [idx].left);
+            if (left_idx < 0 || left_idx > hdr->cap) {
+
+                return READ_TORN;
+            }
+
+            ssize_t left = load_relaxed (&ord [left_idx].size);
+
+            if (nseq == left + 1) {
+
+                return idx;
+            }
+
+            if (nseq <= left) {
+
+                idx = left_idx;
+
+            } else {
+
+                nseq -= left + 1;
+                idx = load_relaxed (&ord [idx].right);
+            }
+        }
+
+        return READ_TORN;
+    }
+
+    bool forward = nseq <= hdr->size / 2;
+    ssize_t steps = forward ? nseq : hdr->size + 1 - nseq;
+
+    ssize_t idx = FICT;
+    for ( ; steps > 0; -- steps) {
+
+        idx = forward ? snap_next (hdr, idx) : snap_prev (hdr, idx);
+        if (idx <= FICT || idx > hdr->cap) {
+
+            return READ_TORN;
+        }
+    }
+
+    return idx;
+}
+
+static ssize_t read_size (list_t *hdr, read_args_t *args) {
+
+    (void) args;
+
+    return hdr->size;
+}
+
+static ssize_t read_take (list_t *hdr, read_args_t *args) {
+
+    if (args->nseq < 1 || args->nseq > hdr->size) {
+
+        return OPER_ERROR_INP;
+    }
+
+    ssize_t pos = snap_node (hdr, args->nseq);
+    if (pos == READ_TORN) {
+
+        return READ_TORN;
+    }
+
+    *args->vals = snap_elem (hdr, pos);
+    return 0;
+}
+
+static ssize_t read_span (list_t *hdr, read_args_t *args) {
+
+    if (args->nseq < 1 || args->nseq > hdr->size) {
+
+        return 0;
+    }
+
+    ssize_t n = (args->n < hdr->size + 1 - args->nseq) ? args->n : hdr->size + 1 - args->nseq;
+
+    ssize_t pos = snap_node (hdr, args->nseq);
+    for (ssize_t i = 0; i < n; ++ i) {
+
+        if (pos <= FICT || pos > hdr->cap) {
+
+            return READ_TORN;
+        }
+
+        args->vals [i] = snap_elem (hdr, pos);
+        pos = hdr->reversed ? snap_prev (hdr, pos) : snap_next (hdr, pos);
+    }
+
+    return n;
+}
@@ -0,0 +1,99 @@
+#ifndef SHARED_LIST_ACTIVE
+#define SHARED_LIST_ACTIVE
+
+#include <atomic>
+#include <mutex>
+
+#include "lst.hpp"
+
+/*
+A list shared between threads: many readers and a few writers.
+
+Writers are serialized by a mutex and bump the sequence counter
+*seq* before and after every change (it's odd while a change
+is in progress). Readers don't lock anything: they copy the list's
+header, check that *seq* was even and didn't change, read the
+nodes the header points to and check *seq* once again; on
+a mismatch they retry, and after SH_READ_TRIES failed attempts
+they take the mutex. Reading is bounded (no more steps than there
+are nodes, every index is checked against the capacity), so a read
+that ran into a change in progress just fails the check.
+
+The readers' loads are relaxed atomics, but the writer changes the
+list with the plain list functions, so for the C++ memory model (and
+for ThreadSanitizer) a read overlapping a write is still a data race,
+one whose result is thrown away. Run ThreadSanitizer with the
+suppressions in tsan.supp (see there): they hide only the races
+with the readers' loads.
+
+Buffers the readers may be looking at are never freed right away:
+the list's retire hook (see list_retire_hook ()) collects them,
+and they are freed after a grace period. Readers announce
+themselves in one of two epochs (counters spread over SH_STRIPES
+cache lines, so that readers on different cores don't share one);
+once the retired buffers are collected, the writer switches the
+epoch, and the buffers are freed by some later writer when all
+the readers of the previous epoch are gone.
+
+Positions got from readers may be stale by the time they're used
+(a writer may have deleted the node, sorted the list or made
+compaction steps), so the read functions return elements; use
+positions only inside shlist_write_begin () / shlist_write_end ()
+*/
+
+constexpr ssize_t SH_STRIPES = 16;
+constexpr ssize_t SH_READ_TRIES = 8;
+
+struct sh_stripe_t {
+
+    alignas (CACHE_LINE) std::atomic<ssize_t> active [2];
+};
+
+struct sh_retired_t {
+
+    void *buf;
+    sh_retired_t *next;
+};
+
+struct shlist_t {
+
+    list_t lst;
+    std::mutex lock;
+
+    alignas (CACHE_LINE) std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> epoch;
+
+    sh_stripe_t readers [SH_STRIPES];
+
+    sh_retired_t *retired;              // Retired in the current epoch
+    sh_retired_t *grace;                // Waiting for the readers of the previous epoch
+};
+
+CTOR_OPER_CODE shlist_ctor (shlist_t *sh, ssize_t cap = 8);
+void shlist_dtor (shlist_t *sh);
+
+/*
+Any list function may be called on the list returned
+by shlist_write_begin () until shlist_write_end ()
+*/
+
+list_t *shlist_write_begin (shlist_t *sh);
+void shlist_write_end (shlist_t *sh);
+
+ssize_t shlist_insert_front (shlist_t *sh, elem_t val);
+ssize_t shlist_insert_back (shlist_t *sh, elem_t val);
+ssize_t shlist_seq_insert_after (shlist_t *sh, elem_t val, ssize_t nseq);
+DEL_SQ_OPER_CODE shlist_seq_delete (shlist_t *sh, ssize_t nseq);
+
+/*
+Readers: shlist_take () puts the element with logical number
+*nseq* to *val* (returns 0 or OPER_ERROR_INP), shlist_read ()
+copies up to *n* elements starting from logical number *nseq*
+to *vals* and returns how many were copied
+*/
+
+ssize_t shlist_size (shlist_t *sh);
+ssize_t shlist_take (shlist_t *sh, ssize_t nseq, elem_t *val);
+ssize_t shlist_read (shlist_t *sh, ssize_t nseq, elem_t *vals, ssize_t n);
+
+#endif